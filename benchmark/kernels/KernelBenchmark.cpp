@@ -0,0 +1,266 @@
+#include <AMReX_ParmParse.H>
+
+#include <KernelBenchmark.H>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+KernelBenchmark::KernelBenchmark(incflo& _solver)
+    : solver(_solver)
+{
+    readParameters();
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(solver.finest_level == 0,
+                                     "Kernel benchmarks only support a single level (amr.max_level = 0)");
+
+    // Compulsory traffic in doubles per cell: reads + writes of all arrays involved
+    const Real b = sizeof(Real);
+    kernels = {
+        {"fillpatch",     b * ( 3 +  3), [this]() {
+            solver.FillPatchVel(0, solver.cur_time, *sborder, 0, sborder->nComp()); }},
+        {"slopes",        b * ( 3 +  9), [this]() {
+            solver.ComputeVelocitySlopes(0, *sborder); }},
+        {"face_velocity", b * ( 6 +  3), [this]() {
+            solver.UpwindVelocityToFaces(0); }},
+        {"ugradu",        b * (15 +  3), [this]() {
+            solver.ComputeConvectiveTerm(0, *solver.conv[0], *solver.vel[0]); }},
+        {"divtau",        b * ( 5 +  3), [this]() {
+            solver.ComputeDivTau(0, *solver.divtau[0], solver.vel); }},
+        {"strainrate",    b * (12 +  4), [this]() {
+            solver.ComputeStrainrate(); }},
+        {"vorticity",     b * (12 +  4), [this]() {
+            auto vort = solver.ComputeVorticity();
+            solver.scratch.release(vort); }}
+    };
+
+    if(!kernel_names.empty())
+    {
+        Vector<Kernel> selected;
+        for(const std::string& name : kernel_names)
+        {
+            bool found = false;
+            for(const Kernel& kernel : kernels)
+            {
+                if(kernel.name == name)
+                {
+                    selected.push_back(kernel);
+                    found = true;
+                }
+            }
+            if(!found) amrex::Abort("Unknown kernel in bench.kernels: " + name);
+        }
+        kernels = selected;
+    }
+}
+
+void KernelBenchmark::readParameters()
+{
+    ParmParse pp("bench");
+
+    pp.query("nrepeat", nrepeat);
+    pp.query("nwarmup", nwarmup);
+    pp.queryarr("max_grid_sizes", max_grid_sizes);
+    pp.queryarr("tile_sizes", tile_sizes);
+    pp.queryarr("kernels", kernel_names);
+    pp.query("output_file", output_file);
+
+    AMREX_ALWAYS_ASSERT(nrepeat > 0);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tile_sizes.size() % 3 == 0,
+                                     "bench.tile_sizes must be given as triplets");
+
+    if(max_grid_sizes.empty())
+    {
+        max_grid_sizes.push_back(solver.maxGridSize(0)[0]);
+    }
+    if(tile_sizes.empty())
+    {
+        const IntVect& ts = FabArrayBase::mfiter_tile_size;
+        tile_sizes = {ts[0], ts[1], ts[2]};
+    }
+}
+
+void KernelBenchmark::run()
+{
+    const IntVect default_tile_size = FabArrayBase::mfiter_tile_size;
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+
+    std::ofstream File;
+    if(ParallelDescriptor::IOProcessor())
+    {
+        File.open(output_file.c_str(), std::ofstream::out | std::ofstream::trunc);
+        if(!File.good())
+            amrex::FileOpenFailed(output_file);
+
+        File << "kernel,max_grid_size,tile_x,tile_y,tile_z,nprocs,nthreads,cells,"
+             << "seconds_per_call,cells_per_sec,bytes_per_cell,gbytes_per_sec\n";
+    }
+
+    for(int max_grid_size : max_grid_sizes)
+    {
+        setGrids(max_grid_size);
+        const long ncells = solver.grids[0].numPts();
+
+        for(int t = 0; t < tile_sizes.size(); t += 3)
+        {
+            const IntVect tile_size(tile_sizes[t], tile_sizes[t + 1], tile_sizes[t + 2]);
+            FabArrayBase::mfiter_tile_size = tile_size;
+
+            amrex::Print() << "\nmax_grid_size = " << max_grid_size
+                           << ", tile size = " << tile_size
+                           << ", " << solver.grids[0].size() << " boxes, "
+                           << ncells << " cells, "
+                           << ParallelDescriptor::NProcs() << " ranks x "
+                           << nthreads << " threads" << std::endl;
+            printTileTypes();
+
+            amrex::Print() << std::left << std::setw(16) << "kernel" << std::right
+                           << std::setw(14) << "s/call"
+                           << std::setw(14) << "cells/s"
+                           << std::setw(12) << "bytes/cell"
+                           << std::setw(10) << "GB/s" << std::endl;
+
+            for(const Kernel& kernel : kernels)
+            {
+                const Real t_call = timeKernel(kernel);
+                const Real rate = (t_call > 0.0) ? ncells / t_call : 0.0;
+                const Real gbps = rate * kernel.bytes_per_cell * 1.e-9;
+
+                amrex::Print() << std::left << std::setw(16) << kernel.name << std::right
+                               << std::setw(14) << t_call
+                               << std::setw(14) << rate
+                               << std::setw(12) << kernel.bytes_per_cell
+                               << std::setw(10) << gbps << std::endl;
+
+                if(ParallelDescriptor::IOProcessor())
+                {
+                    File << kernel.name << "," << max_grid_size << ","
+                         << tile_size[0] << "," << tile_size[1] << "," << tile_size[2] << ","
+                         << ParallelDescriptor::NProcs() << "," << nthreads << ","
+                         << ncells << "," << t_call << "," << rate << ","
+                         << kernel.bytes_per_cell << "," << gbps << "\n";
+                }
+            }
+        }
+    }
+
+    solver.ReleaseSlopes();
+    FabArrayBase::mfiter_tile_size = default_tile_size;
+
+    amrex::Print() << "\nWrote kernel benchmark results to " << output_file << std::endl;
+}
+
+void KernelBenchmark::setGrids(int max_grid_size)
+{
+    // The slopes of the previous grids go back to the pool before it is cleared
+    solver.ReleaseSlopes();
+
+    BoxArray ba(solver.geom[0].Domain());
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba, ParallelDescriptor::NProcs());
+
+    solver.SetBoxArray(0, ba);
+    solver.SetDistributionMap(0, dm);
+    solver.RegridArrays(0);
+
+    sborder.reset(new MultiFab(solver.grids[0], solver.dmap[0], AMREX_SPACEDIM, solver.nghost,
+                               MFInfo(), *solver.ebfactory[0]));
+
+    initFields();
+}
+
+void KernelBenchmark::initFields()
+{
+    const Geometry& geom = solver.geom[0];
+    const Real* plo = geom.ProbLo();
+    const Real* dx = geom.CellSize();
+
+    // One period of a Taylor-Green-like field across the domain, on top of the initial velocity,
+    // so that all branches of the limiters and upwinding get exercised
+    const Real kx = 2.0 * M_PI / geom.ProbLength(0);
+    const Real ky = 2.0 * M_PI / geom.ProbLength(1);
+    const Real kz = 2.0 * M_PI / geom.ProbLength(2);
+    const Real u0 = solver.ic_u;
+    const Real v0 = solver.ic_v;
+    const Real w0 = solver.ic_w;
+
+    MultiFab& vel = *solver.vel[0];
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for(MFIter mfi(vel, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& vel_arr = vel.array(mfi);
+
+        AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+        {
+            Real x = plo[0] + (i + 0.5) * dx[0];
+            Real y = plo[1] + (j + 0.5) * dx[1];
+            Real z = plo[2] + (k + 0.5) * dx[2];
+
+            vel_arr(i,j,k,0) = u0 + sin(kx * x) * cos(ky * y) * cos(kz * z);
+            vel_arr(i,j,k,1) = v0 - cos(kx * x) * sin(ky * y) * cos(kz * z);
+            vel_arr(i,j,k,2) = w0 + 0.5 * cos(kx * x) * cos(ky * y) * sin(kz * z);
+        });
+    }
+    solver.ro[0]->setVal(solver.ro_0);
+
+    // Ghost cells, slopes, face velocities and viscosity for the kernels that need them. The
+    // slopes stay held until the grids change.
+    solver.FillPatchVel(0, solver.cur_time, *sborder, 0, sborder->nComp());
+    solver.ComputeVelocityAtFaces(solver.vel, solver.cur_time);
+    solver.ComputeStrainrate();
+    solver.ComputeViscosity();
+}
+
+Real KernelBenchmark::timeKernel(const Kernel& kernel) const
+{
+    for(int n = 0; n < nwarmup; n++) kernel.f();
+
+    ParallelDescriptor::Barrier();
+    Real strt_time = ParallelDescriptor::second();
+
+    for(int n = 0; n < nrepeat; n++) kernel.f();
+
+    ParallelDescriptor::Barrier();
+    Real t_call = (ParallelDescriptor::second() - strt_time) / nrepeat;
+    ParallelDescriptor::ReduceRealMax(t_call);
+
+    return t_call;
+}
+
+void KernelBenchmark::printTileTypes() const
+{
+    const auto& flags = solver.ebfactory[0]->getMultiEBCellFlagFab();
+
+    // Regular, cut and covered tiles, and tiles which are regular but have cut cells in the
+    // ghost region (these take the EB path in kernels that look at a grown tile box)
+    long ntiles[4] = {0, 0, 0, 0};
+    for(MFIter mfi(*solver.vel[0], true); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const FabType type = flags[mfi].getType(bx);
+
+        if(type == FabType::covered)
+            ntiles[2]++;
+        else if(type == FabType::regular)
+            ntiles[flags[mfi].getType(amrex::grow(bx, solver.nghost)) == FabType::regular ? 0 : 3]++;
+        else
+            ntiles[1]++;
+    }
+    ParallelDescriptor::ReduceLongSum(ntiles, 4);
+
+    amrex::Print() << "Tiles: " << ntiles[0] << " regular, " << ntiles[1] << " cut, "
+                   << ntiles[2] << " covered, " << ntiles[3] << " regular with cut ghost cells"
+                   << std::endl;
+}
@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+"""
+Strong and weak scaling suite for incflo.
+
+Generates inputs files from the problems in exec/, runs each of them for a fixed number of
+steps over a range of MPI rank and OpenMP thread counts, and collects from the phase timer
+reports (timer.report_file):
+
+  * the time per step, and its split over the main phases (advection, MAC projection,
+    diffusion, nodal projection, ...)
+  * the cell updates per second
+  * the parallel efficiency with respect to the smallest rank count of the case
+
+Every run is appended to a history file (one JSON record per line). The cell updates per
+second are compared against a baseline file, and the script exits with a non-zero status
+if any run is slower than the baseline by more than the tolerance.
+
+Usage:
+
+    ./run_scaling.py [--suite scaling.ini] [--cases name ...] [--executable path]
+                     [--update-baseline] [--no-run]
+"""
+
+import argparse
+import configparser
+import datetime
+import json
+import os
+import platform
+import shlex
+import subprocess
+import sys
+
+# Phases reported separately. Times are summed over all nodes with this name in the timer tree.
+PHASES = ["ComputeDt", "ComputeUGradU", "MacProjection", "ComputeDivTau", "DiffusionSolve",
+          "ApplyProjection", "ComputeViscosity", "FillPatchVel"]
+
+
+def read_suite(filename):
+    suite = configparser.ConfigParser()
+    suite.optionxform = str
+    if not suite.read(filename):
+        sys.exit("Cannot read suite file {}".format(filename))
+
+    top = os.path.dirname(os.path.abspath(filename))
+
+    def path(p):
+        return p if os.path.isabs(p) else os.path.normpath(os.path.join(top, p))
+
+    main = suite["main"]
+    params = {
+        "executable":  path(main.get("executable")),
+        "mpi_command": main.get("MPIcommand", "mpiexec -n @nprocs@ @command@"),
+        "nsteps":      main.getint("numSteps", 20),
+        "nwarmup":     main.getint("warmupSteps", 2),
+        "run_dir":     path(main.get("runDir", "runs")),
+        "history":     path(main.get("historyFile", "history.jsonl")),
+        "baseline":    path(main.get("baselineFile", "baseline.json")),
+        "tolerance":   main.getfloat("tolerance", 0.1),
+    }
+
+    cases = []
+    for name in suite.sections():
+        if name == "main":
+            continue
+        sec = suite[name]
+        case = {
+            "name":          name,
+            "inputs":        path(sec.get("inputs")),
+            "type":          sec.get("type", "strong"),
+            "n_cell":        [int(n) for n in sec.get("n_cell").split()],
+            "max_grid_size": sec.getint("maxGridSize", 32),
+            "nprocs":        [int(n) for n in sec.get("numprocs", "1").split()],
+            "nthreads":      [int(n) for n in sec.get("numthreads", "1").split()],
+            "overrides":     [o.strip() for o in sec.get("overrides", "").split(";") if o.strip()],
+        }
+        if case["type"] not in ("strong", "weak"):
+            sys.exit("Case {}: type must be strong or weak".format(name))
+        if case["type"] == "weak":
+            for n in case["nprocs"]:
+                if n & (n - 1) != 0:
+                    sys.exit("Case {}: weak scaling needs powers of two for numprocs".format(name))
+        cases.append(case)
+
+    return params, cases
+
+
+def weak_n_cell(n_cell, factor):
+    """Refine the mesh by an integer power-of-two factor, one direction at a time"""
+    n_cell = list(n_cell)
+    d = 0
+    while factor > 1:
+        n_cell[d] *= 2
+        factor //= 2
+        d = (d + 1) % 3
+    return n_cell
+
+
+def write_inputs(case, n_cell, params, filename):
+    """The original inputs followed by the overrides: ParmParse uses the last definition"""
+    with open(case["inputs"]) as f:
+        inputs = f.read()
+
+    overrides = [
+        "amr.n_cell = {} {} {}".format(*n_cell),
+        "amr.max_grid_size = {}".format(case["max_grid_size"]),
+        "max_step = {}".format(params["nsteps"]),
+        "stop_time = -1",
+        "steady_state = 0",
+        "amr.plot_int = -1",
+        "amr.plot_per = -1",
+        "amr.check_int = -1",
+        "stats.start_time = -1",
+        "sampling.int = -1",
+        "timer.enable = 1",
+        "timer.report_int = 1",
+        "timer.report_file = timers.json",
+        "timer.summary = 1",
+    ] + case["overrides"]
+
+    with open(filename, "w") as f:
+        f.write(inputs)
+        f.write("\n\n# Scaling suite overrides\n")
+        f.write("\n".join(overrides) + "\n")
+
+
+def flatten(phases, totals):
+    for name, node in phases.get("children", {}).items():
+        totals[name] = totals.get(name, 0.0) + node["max"]
+        flatten(node, totals)
+
+
+def read_timers(filename, nwarmup):
+    """Average time per step and phase times per step over the steps after the warm-up"""
+    records = []
+    with open(filename) as f:
+        for line in f:
+            if line.strip():
+                records.append(json.loads(line))
+    records = [r for r in records if r["step"] > nwarmup]
+    if not records:
+        return None
+
+    nsteps = len(records)
+    step_time = sum(r["phases"]["max"] for r in records) / nsteps
+    cells = sum(r["cell_updates"] for r in records) / nsteps
+
+    totals = {}
+    for r in records:
+        flatten(r["phases"], totals)
+    phases = {p: totals.get(p, 0.0) / nsteps for p in PHASES}
+
+    return {
+        "steps":                nsteps,
+        "cells":                cells,
+        "time_per_step":        step_time,
+        "cell_updates_per_sec": cells / step_time if step_time > 0 else 0.0,
+        "phases":               phases,
+    }
+
+
+def git_hash(directory):
+    try:
+        return subprocess.check_output(["git", "rev-parse", "HEAD"], cwd=directory,
+                                       stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ""
+
+
+def run_case(case, params, run):
+    results = []
+    nmin = min(case["nprocs"])
+
+    for nthreads in case["nthreads"]:
+        for nprocs in case["nprocs"]:
+            if case["type"] == "weak":
+                n_cell = weak_n_cell(case["n_cell"], nprocs // nmin)
+            else:
+                n_cell = case["n_cell"]
+
+            tag = "{}_{}x{}".format(case["name"], nprocs, nthreads)
+            rundir = os.path.join(params["run_dir"], tag)
+            os.makedirs(rundir, exist_ok=True)
+
+            if run:
+                write_inputs(case, n_cell, params, os.path.join(rundir, "inputs"))
+                timers = os.path.join(rundir, "timers.json")
+                if os.path.exists(timers):
+                    os.remove(timers)
+
+                command = params["mpi_command"].replace("@nprocs@", str(nprocs))
+                command = command.replace("@command@",
+                                          "{} inputs".format(shlex.quote(params["executable"])))
+                env = dict(os.environ, OMP_NUM_THREADS=str(nthreads))
+
+                print("Running {} ({} cells)".format(tag, n_cell), flush=True)
+                with open(os.path.join(rundir, "output.txt"), "w") as out:
+                    status = subprocess.call(command, shell=True, cwd=rundir, env=env,
+                                             stdout=out, stderr=subprocess.STDOUT)
+                if status != 0:
+                    print("  FAILED with status {}, see {}/output.txt".format(status, rundir))
+                    continue
+
+            metrics = read_timers(os.path.join(rundir, "timers.json"), params["nwarmup"])
+            if metrics is None:
+                print("  No timer records for {}".format(tag))
+                continue
+
+            results.append(dict(case=case["name"], type=case["type"], nprocs=nprocs,
+                                nthreads=nthreads, n_cell=n_cell,
+                                max_grid_size=case["max_grid_size"], **metrics))
+
+    # Parallel efficiency relative to the smallest rank count with the same thread count
+    for r in results:
+        ref = [s for s in results if s["nthreads"] == r["nthreads"] and s["nprocs"] == nmin]
+        if not ref or r["time_per_step"] <= 0.0:
+            r["efficiency"] = None
+        elif case["type"] == "strong":
+            r["efficiency"] = (ref[0]["time_per_step"] * nmin) / (r["time_per_step"] * r["nprocs"])
+        else:
+            r["efficiency"] = ref[0]["time_per_step"] / r["time_per_step"]
+
+    return results
+
+
+def key(r):
+    return "{}/{}x{}".format(r["case"], r["nprocs"], r["nthreads"])
+
+
+def report(results, baseline, tolerance):
+    """Print the results and return the number of runs slower than the baseline"""
+    print("\n{:<36}{:>12}{:>14}{:>8}{:>12}".format("run", "s/step", "cells/s", "eff", "vs base"))
+    nfail = 0
+    for r in results:
+        eff = "{:.2f}".format(r["efficiency"]) if r["efficiency"] is not None else "-"
+        base = baseline.get(key(r))
+        if base:
+            ratio = r["cell_updates_per_sec"] / base
+            cmp = "{:+.1f}%".format(100.0 * (ratio - 1.0))
+            if ratio < 1.0 - tolerance:
+                cmp += " FAIL"
+                nfail += 1
+        else:
+            cmp = "-"
+        print("{:<36}{:>12.4g}{:>14.4g}{:>8}{:>12}".format(
+            key(r), r["time_per_step"], r["cell_updates_per_sec"], eff, cmp))
+        print("    " + ", ".join("{} {:.3g}".format(p, t) for p, t in r["phases"].items() if t > 0.0))
+    return nfail
+
+
+def main():
+    parser = argparse.ArgumentParser(description="incflo strong/weak scaling suite")
+    parser.add_argument("--suite", default=os.path.join(os.path.dirname(__file__), "scaling.ini"))
+    parser.add_argument("--cases", nargs="*", help="only run these cases")
+    parser.add_argument("--executable", help="override the executable in the suite file")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="store the results of this run as the new baseline")
+    parser.add_argument("--no-run", action="store_true",
+                        help="don't run, only analyse the timer files of previous runs")
+    args = parser.parse_args()
+
+    params, cases = read_suite(args.suite)
+    if args.executable:
+        params["executable"] = os.path.abspath(args.executable)
+    if args.cases:
+        cases = [c for c in cases if c["name"] in args.cases]
+
+    if not args.no_run and not os.access(params["executable"], os.X_OK):
+        sys.exit("Executable {} not found, build incflo first".format(params["executable"]))
+
+    results = []
+    for case in cases:
+        results += run_case(case, params, not args.no_run)
+
+    baseline = {}
+    if os.path.exists(params["baseline"]):
+        with open(params["baseline"]) as f:
+            baseline = json.load(f)
+
+    nfail = report(results, baseline, params["tolerance"])
+
+    # Append to the history
+    stamp = datetime.datetime.now().isoformat(timespec="seconds")
+    commit = git_hash(os.path.dirname(params["executable"]))
+    with open(params["history"], "a") as f:
+        for r in results:
+            f.write(json.dumps(dict(date=stamp, git=commit, host=platform.node(), **r)) + "\n")
+
+    if args.update_baseline:
+        baseline.update({key(r): r["cell_updates_per_sec"] for r in results})
+        with open(params["baseline"], "w") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+        print("\nUpdated baseline {}".format(params["baseline"]))
+    elif nfail > 0:
+        print("\n{} run(s) more than {:.0f}% slower than the baseline".format(
+            nfail, 100.0 * params["tolerance"]))
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -4,6 +4,7 @@
 #include <AMReX_Box.H>
 #include <AMReX_EBMultiFabUtil.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_VisMF.H>
 
@@ -17,6 +18,7 @@
 void incflo::Advance()
 {
     BL_PROFILE("incflo::Advance");
+    INCFLO_TIMER("Advance");
 
     // Start timing current time step
     Real strt_step = ParallelDescriptor::second();
@@ -34,6 +36,13 @@ void incflo::Advance()
     int initialisation = 0;
     ComputeDt(initialisation);
 
+    // Local pseudo-time steps for the steady state
+    const Real lts_cfl_start = lts_cfl;
+    if(steady_state_lts)
+    {
+        ComputeLocalTimeStep();
+    }
+
     // Set new and old time to correctly use in fillpatching
     for(int lev = 0; lev <= finest_level; lev++)
     {
@@ -55,9 +64,91 @@ void incflo::Advance()
         MultiFab::Copy(*vel_o[lev], *vel[lev], 0, 0, vel[lev]->nComp(), vel_o[lev]->nGrow());
     }
 
-    ApplyPredictor();
+    // The step is the map of a fixed-point iteration for the steady state
+    Vector<std::unique_ptr<MultiFab>> anderson_weight;
+    if(anderson)
+    {
+        anderson->start(IterationState(), IterationWeights(anderson_weight));
+    }
+
+    // With implicit_viscosity, the step is redone with the viscous dt limit if the implicit
+    // viscous solve does not converge. This needs the pressure the step starts from.
+    Vector<std::unique_ptr<MultiFab>> p_start(finest_level + 1);
+    Vector<std::unique_ptr<MultiFab>> gp_start(finest_level + 1);
+    if(implicit_viscosity)
+    {
+        for(int lev = 0; lev <= finest_level; lev++)
+        {
+            p_start[lev] = scratch.acquire(p[lev]->boxArray(), dmap[lev], 1, p[lev]->nGrow(),
+                                           *ebfactory[lev]);
+            gp_start[lev] = scratch.acquire(grids[lev], dmap[lev], AMREX_SPACEDIM, gp[lev]->nGrow(),
+                                            *ebfactory[lev]);
+            MultiFab::Copy(*p_start[lev], *p[lev], 0, 0, 1, p[lev]->nGrow());
+            MultiFab::Copy(*gp_start[lev], *gp[lev], 0, 0, AMREX_SPACEDIM, gp[lev]->nGrow());
+        }
+    }
+
+    bool converged = ApplyPredictor();
+    converged = ApplyCorrector() && converged;
+
+    if(!converged && fixed_dt <= 0.0)
+    {
+        amrex::Print() << "Warning: step rejected, redone with the viscous dt limit" << std::endl;
+
+        for(int lev = 0; lev <= finest_level; lev++)
+        {
+            MultiFab::Copy(*vel[lev], *vel_o[lev], 0, 0, vel[lev]->nComp(), vel[lev]->nGrow());
+            MultiFab::Copy(*p[lev], *p_start[lev], 0, 0, 1, p[lev]->nGrow());
+            MultiFab::Copy(*gp[lev], *gp_start[lev], 0, 0, AMREX_SPACEDIM, gp[lev]->nGrow());
+        }
+
+        viscous_dt_limit = true;
+        ComputeDt(initialisation);
+        if(steady_state_lts)
+        {
+            lts_cfl = lts_cfl_start;
+            ComputeLocalTimeStep();
+        }
+        viscous_dt_limit = false;
+
+        for(int lev = 0; lev <= finest_level; lev++)
+        {
+            t_new[lev] = cur_time + dt;
+        }
+
+        if(incflo_verbose > 0)
+        {
+            amrex::Print() << "\nStep " << nstep + 1
+                           << ": from old_time " << cur_time
+                           << " to new time " << cur_time + dt
+                           << " with dt = " << dt << ".\n" << std::endl;
+        }
+
+        converged = ApplyPredictor();
+        converged = ApplyCorrector() && converged;
+    }
+
+    if(!converged)
+    {
+        amrex::Print() << "Warning: implicit viscous solve not converged, last iterate kept" << std::endl;
+    }
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        scratch.release(std::move(p_start[lev]));
+        scratch.release(std::move(gp_start[lev]));
+    }
+
+    if(anderson)
+    {
+        anderson->accelerate(IterationState());
+        FillVelocityBC(cur_time + dt, 0);
 
-    ApplyCorrector();
+        for(int lev = 0; lev <= finest_level; lev++)
+        {
+            scratch.release(std::move(anderson_weight[lev]));
+        }
+    }
 
     if(incflo_verbose > 1)
     {
@@ -65,8 +156,21 @@ void incflo::Advance()
         PrintMaxValues(cur_time + dt);
         if(probtype%10 == 3 or probtype == 5)
         {
-            ComputeDrag();
-            amrex::Print() << "Drag force = " << (*drag[0]).sum(0, false) << std::endl; 
+            // Pressure and viscous force, summed over the bodies
+            Vector<Real> values;
+            ComputeForces(values);
+
+            RealArray force = {0.0, 0.0, 0.0};
+            for(int b = 0; b < force_monitor->numBodies(); b++)
+            {
+                for(int n = 0; n < 3; n++)
+                {
+                    force[n] += values[ForceMonitor::nvalues * b + n]
+                              + values[ForceMonitor::nvalues * b + n + 3];
+                }
+            }
+            amrex::Print() << "Force on the EB = (" << force[0] << ", " << force[1] << ", "
+                           << force[2] << ")" << std::endl;
         }
     }
 
@@ -103,6 +207,13 @@ void incflo::Advance()
 //
 //     ( 1 - dt / rho * div ( eta grad ) ) u* = rhs
 //
+//     With implicit_viscosity, divtau is left out of rhs and taken in by the solve instead
+//     (see SolveViscousImplicit):
+//
+//     ( 1 - dt / rho * div ( eta grad ) ) u* - dt / rho * div ( eta (grad u*)^T ) = rhs
+//
+//     and false is returned if this does not converge.
+//
 //  4. Apply projection
 //     
 //     Add pressure gradient term back to u*: 
@@ -121,9 +232,10 @@ void incflo::Advance()
 //
 //     vel = u** - dt * grad p / rho
 //
-void incflo::ApplyPredictor()
+bool incflo::ApplyPredictor()
 {
     BL_PROFILE("incflo::ApplyPredictor");
+    INCFLO_TIMER("ApplyPredictor");
 
     // We use the new ime value for things computed on the "*" state
     Real new_time = cur_time + dt;
@@ -134,40 +246,69 @@ void incflo::ApplyPredictor()
         PrintMaxValues(new_time);
     }
 
+    // Density of the momentum updates (divided by the local time step ratio for local time steps)
+    const Vector<std::unique_ptr<MultiFab>>& ro_step = StepDensity();
+
     // Compute the explicit advective term: conv = - u dot grad(u)
     ComputeUGradU(conv_old, vel_o, cur_time);
 
     // Update the derived quantities, notably strain-rate tensor and viscosity
-    UpdateDerivedQuantities();
+    // (a constant viscosity is set in PostInit)
+    if(!constant_viscosity)
+    {
+        UpdateDerivedQuantities();
+    }
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
         // Save this value of eta as eta_old for use in the corrector as well
-        MultiFab::Copy(*eta_old[lev], *eta[lev], 0, 0, eta[lev]->nComp(), eta_old[lev]->nGrow());
+        if(!constant_viscosity)
+        {
+            MultiFab::Copy(*eta_old[lev], *eta[lev], 0, 0, eta[lev]->nComp(), eta_old[lev]->nGrow());
+        }
 
         // compute only the off-diagonal terms here
         ComputeDivTau(lev, *divtau_old[lev], vel_o);
 
+        // With local time steps, every cell advances by its own step
+        ScaleByLocalTimeStep(lev, *conv_old[lev]);
+        ScaleByLocalTimeStep(lev, *divtau_old[lev]);
+
         // First add the convective term
         MultiFab::Saxpy(*vel[lev], dt, *conv_old[lev], 0, 0, AMREX_SPACEDIM, 0);
 
-        // Add the viscous terms         
-        MultiFab::Saxpy(*vel[lev], dt, *divtau_old[lev], 0, 0, AMREX_SPACEDIM, 0);
+        // Add the viscous terms (the implicit solve takes them in with implicit_viscosity)
+        if(!implicit_viscosity)
+        {
+            MultiFab::Saxpy(*vel[lev], dt, *divtau_old[lev], 0, 0, AMREX_SPACEDIM, 0);
+        }
 
         // Add gravitational forces
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
-            (*vel[lev]).plus(dt * gravity[dir], dir, 1, 0);
+            if(lts_active)
+            {
+                MultiFab::Saxpy(*vel[lev], dt * gravity[dir], *lts_ratio[lev], 0, dir, 1, 0);
+            }
+            else
+            {
+                (*vel[lev]).plus(dt * gravity[dir], dir, 1, 0);
+            }
         }
 
         // Convert velocities to momenta
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
-            MultiFab::Multiply(*vel[lev], (*ro[lev]), 0, dir, 1, vel[lev]->nGrow());
+            MultiFab::Multiply(*vel[lev], (*ro_step[lev]), 0, dir, 1, vel[lev]->nGrow());
         }
 
-        // Add (-dt grad p to momenta)
-        MultiFab::Saxpy(*vel[lev], -dt, *gp[lev], 0, 0, AMREX_SPACEDIM, vel[lev]->nGrow());
+        // Add (-dt grad p to momenta). This covers the ng_gp ghost layers of gp only; the
+        // outer layers of vel are not read before they are refilled: FillVelocityBC below
+        // overwrites those at the domain boundaries and between boxes, and the kernels that
+        // read them (ComputeUGradU, strain rate, vorticity) get the velocity through
+        // FillPatchVel, which also fills the coarse-fine ghost cells. Diffusion and the
+        // projection use one ghost layer.
+        MultiFab::Saxpy(*vel[lev], -dt, *gp[lev], 0, 0, AMREX_SPACEDIM, gp[lev]->nGrow());
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
             (*vel[lev]).plus(-dt * gp0[dir], dir, 1, 0);
@@ -176,19 +317,29 @@ void incflo::ApplyPredictor()
         // Convert momenta back to velocities
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
-            MultiFab::Divide(*vel[lev], (*ro[lev]), 0, dir, 1, vel[lev]->nGrow());
+            MultiFab::Divide(*vel[lev], (*ro_step[lev]), 0, dir, 1, vel[lev]->nGrow());
         }
     }
     FillVelocityBC(new_time, 0);
 
     // Solve implicit diffusion equation for u*
-    diffusion_equation->solve(vel, ro, eta, dt);
+    bool converged = true;
+    if(implicit_viscosity)
+    {
+        converged = SolveViscousImplicit(divtau_old, new_time);
+    }
+    else
+    {
+        diffusion_equation->solve(vel, ro_step, eta, dt);
+    }
 
     // Project velocity field, update pressure
     ApplyProjection(new_time, dt);
 
     // Fill velocity BCs again
     FillVelocityBC(new_time, 0);
+
+    return converged;
 }
 
 //
@@ -219,6 +370,13 @@ void incflo::ApplyPredictor()
 //
 //     ( 1 - dt / rho * div ( eta grad ) ) u* = rhs
 //
+//     With implicit_viscosity, divtau is left out of rhs and taken in by the solve instead
+//     (see SolveViscousImplicit):
+//
+//     ( 1 - dt / rho * div ( eta grad ) ) u* - dt / rho * div ( eta (grad u*)^T ) = rhs
+//
+//     and false is returned if this does not converge.
+//
 //  4. Apply projection
 //     
 //     Add pressure gradient term back to u*: 
@@ -237,9 +395,10 @@ void incflo::ApplyPredictor()
 //
 //     vel = u** - dt * grad p / rho
 //
-void incflo::ApplyCorrector()
+bool incflo::ApplyCorrector()
 {
 	BL_PROFILE("incflo::ApplyCorrector");
+	INCFLO_TIMER("ApplyCorrector");
 
     // We use the new time value for things computed on the "*" state
     Real new_time = cur_time + dt;
@@ -250,39 +409,61 @@ void incflo::ApplyCorrector()
         PrintMaxValues(new_time);
     }
 
+    // Density of the momentum updates (divided by the local time step ratio for local time steps)
+    const Vector<std::unique_ptr<MultiFab>>& ro_step = StepDensity();
+
     // Compute the explicit advective term: conv = - u dot grad(u)
     ComputeUGradU(conv, vel, new_time);
 
     // Update the derived quantities, notably strain-rate tensor and viscosity
-    UpdateDerivedQuantities();
+    // (a constant viscosity is set in PostInit)
+    if(!constant_viscosity)
+    {
+        UpdateDerivedQuantities();
+    }
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
         // compute only the off-diagonal terms here
         ComputeDivTau(lev, *divtau[lev], vel);
 
+        // With local time steps, every cell advances by its own step (conv_old and divtau_old
+        // have been scaled in the predictor)
+        ScaleByLocalTimeStep(lev, *conv[lev]);
+        ScaleByLocalTimeStep(lev, *divtau[lev]);
+
         // First add the convective terms
         MultiFab::LinComb(*vel[lev], 1.0, *vel_o[lev], 0, dt / 2.0, *conv[lev], 0, 0, AMREX_SPACEDIM, 0);
         MultiFab::Saxpy(*vel[lev], dt / 2.0, *conv_old[lev], 0, 0, AMREX_SPACEDIM, 0);
 
-        // Add the viscous terms         
-        MultiFab::Saxpy(*vel[lev], dt / 2.0, *divtau[lev], 0, 0, AMREX_SPACEDIM, 0);
-        MultiFab::Saxpy(*vel[lev], dt / 2.0, *divtau_old[lev], 0, 0, AMREX_SPACEDIM, 0);
+        // Add the viscous terms (the implicit solve takes them in with implicit_viscosity)
+        if(!implicit_viscosity)
+        {
+            MultiFab::Saxpy(*vel[lev], dt / 2.0, *divtau[lev], 0, 0, AMREX_SPACEDIM, 0);
+            MultiFab::Saxpy(*vel[lev], dt / 2.0, *divtau_old[lev], 0, 0, AMREX_SPACEDIM, 0);
+        }
 
         // Add gravitational forces
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
-            (*vel[lev]).plus(dt * gravity[dir], dir, 1, 0);
+            if(lts_active)
+            {
+                MultiFab::Saxpy(*vel[lev], dt * gravity[dir], *lts_ratio[lev], 0, dir, 1, 0);
+            }
+            else
+            {
+                (*vel[lev]).plus(dt * gravity[dir], dir, 1, 0);
+            }
         }
 
         // Convert velocities to momenta
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
-            MultiFab::Multiply(*vel[lev], (*ro[lev]), 0, dir, 1, vel[lev]->nGrow());
+            MultiFab::Multiply(*vel[lev], (*ro_step[lev]), 0, dir, 1, vel[lev]->nGrow());
         }
 
-        // Add (-dt grad p to momenta)
-        MultiFab::Saxpy(*vel[lev], -dt, *gp[lev], 0, 0, AMREX_SPACEDIM, vel[lev]->nGrow());
+        // Add (-dt grad p to momenta), over the ghost layers of gp only (see ApplyPredictor)
+        MultiFab::Saxpy(*vel[lev], -dt, *gp[lev], 0, 0, AMREX_SPACEDIM, gp[lev]->nGrow());
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
             (*vel[lev]).plus(-dt * gp0[dir], dir, 1, 0);
@@ -291,22 +472,35 @@ void incflo::ApplyCorrector()
         // Convert momenta back to velocities
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
-            MultiFab::Divide(*vel[lev], (*ro[lev]), 0, dir, 1, vel[lev]->nGrow());
+            MultiFab::Divide(*vel[lev], (*ro_step[lev]), 0, dir, 1, vel[lev]->nGrow());
         }
 
         // Take eta as the average of the predictor and corrector values
-        MultiFab::LinComb(*eta[lev], 0.5, *eta_old[lev], 0, 0.5, *eta[lev], 0, 0, 1, 0);
+        if(!constant_viscosity)
+        {
+            MultiFab::LinComb(*eta[lev], 0.5, *eta_old[lev], 0, 0.5, *eta[lev], 0, 0, 1, 0);
+        }
     }
     FillVelocityBC(new_time, 0);
 
     // Solve implicit diffusion equation for u*
-    diffusion_equation->solve(vel, ro, eta, dt);
+    bool converged = true;
+    if(implicit_viscosity)
+    {
+        converged = SolveViscousImplicit(divtau, new_time);
+    }
+    else
+    {
+        diffusion_equation->solve(vel, ro_step, eta, dt);
+    }
 
     // Project velocity field, update pressure
     ApplyProjection(new_time, dt);
 
     // Fill velocity BCs again
 	FillVelocityBC(new_time, 0);
+
+    return converged;
 }
 
 //
@@ -326,6 +520,23 @@ bool incflo::SteadyStateReached()
 {
     BL_PROFILE("incflo::SteadyStateReached()");
 
+    // With local time steps the change of u depends on the local step, use the residual instead
+    if(lts_active)
+    {
+        lts_residual = ComputeResidual();
+        lts_residual_0 = amrex::max(lts_residual_0, lts_residual);
+
+        Real relresidual = lts_residual_0 > 1.0e-15 ? lts_residual / lts_residual_0 : 0.0;
+
+        if(incflo_verbose > 0)
+        {
+            amrex::Print() << "\nSteady state check: residual = " << lts_residual
+                           << ", residual / max residual = " << relresidual << std::endl;
+        }
+
+        return nstep >= 2 && (lts_residual < steady_state_tol || relresidual < steady_state_tol);
+    }
+
     int condition1[finest_level + 1];
     int condition2[finest_level + 1];
 
@@ -337,7 +548,7 @@ bool incflo::SteadyStateReached()
     diff_vel.resize(finest_level + 1);
     for(int lev = 0; lev <= finest_level; lev++)
     {
-        diff_vel[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, 0, MFInfo(), *ebfactory[lev]));
+        diff_vel[lev] = scratch.acquire(grids[lev], dmap[lev], AMREX_SPACEDIM, 0, *ebfactory[lev]);
         MultiFab::LinComb(*diff_vel[lev], 1.0, *vel[lev], 0, -1.0, *vel_o[lev], 0, 0, AMREX_SPACEDIM, 0);
 
         Real max_change = 0.0;
@@ -366,6 +577,8 @@ bool incflo::SteadyStateReached()
             amrex::Print() << "||u-uo||/||uo|| = " << max_relchange
                            << ", du/dt  = " << max_change/dt << std::endl;
         }
+
+        scratch.release(std::move(diff_vel[lev]));
     }
 
     bool reached = true;
@@ -383,3 +596,123 @@ bool incflo::SteadyStateReached()
         return reached;
     }
 }
+
+//
+// Residual of the steady momentum equations with local time steps: the pseudo-time derivative
+//
+//      max(abs( u^(n+1) - u^(n) ) / (dt * s))
+//
+// over the uncovered cells of all levels and all components, with s the local time step ratio
+//
+Real incflo::ComputeResidual()
+{
+    BL_PROFILE("incflo::ComputeResidual()");
+
+    Real residual = 0.0;
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        const EBTiles& tiles = GetEBTiles(lev);
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(max:residual) if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            if(tiles.type(mfi, 0) == FabType::covered) continue;
+
+            const Box& bx = mfi.tilebox();
+
+            const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>((*vel[lev])[mfi]);
+            const auto& flag_arr = vel_fab.getEBCellFlagFab().array();
+
+            const auto& vel_arr = vel[lev]->array(mfi);
+            const auto& vel_o_arr = vel_o[lev]->array(mfi);
+            const auto& ratio_arr = lts_ratio[lev]->array(mfi);
+
+            for(int n = 0; n < AMREX_SPACEDIM; n++)
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                if(flag_arr(i,j,k).isCovered()) continue;
+
+                Real r = std::abs(vel_arr(i,j,k,n) - vel_o_arr(i,j,k,n)) / (dt * ratio_arr(i,j,k));
+                residual = amrex::max(residual, r);
+            }
+        }
+    }
+
+    ParallelDescriptor::ReduceRealMax(residual);
+
+    return residual;
+}
+
+//
+// Fields the steps act on as a fixed-point map, for Anderson acceleration: the velocity and the
+// (lagged) pressure gradient of all levels. The pressure itself is recomputed by every
+// projection.
+//
+Vector<MultiFab*> incflo::IterationState()
+{
+    Vector<MultiFab*> state;
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        state.push_back(vel[lev].get());
+        state.push_back(gp[lev].get());
+    }
+    return state;
+}
+
+//
+// Weights of the norm of IterationState() for Anderson acceleration: the fluid volume of the
+// cells relative to those of level 0. They are zero in the covered cells, which hold
+// covered_val, and in the cells covered by the next finer level, whose values are only the
+// average of the fine ones.
+//
+Vector<const MultiFab*> incflo::IterationWeights(Vector<std::unique_ptr<MultiFab>>& weight)
+{
+    weight.resize(finest_level + 1);
+
+    Vector<const MultiFab*> weights;
+    Real dv = 1.0;
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        if(lev > 0)
+        {
+            dv /= AMREX_D_TERM(refRatio(lev - 1)[0], * refRatio(lev - 1)[1], * refRatio(lev - 1)[2]);
+        }
+
+        weight[lev] = scratch.acquire(grids[lev], dmap[lev], 1, 0, *ebfactory[lev]);
+        MultiFab::Copy(*weight[lev], ebfactory[lev]->getVolFrac(), 0, 0, 1, 0);
+        weight[lev]->mult(dv);
+
+        if(lev < finest_level)
+        {
+            const iMultiFab fine_mask = amrex::makeFineMask(grids[lev], dmap[lev],
+                                                            grids[lev + 1], refRatio(lev));
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for(MFIter mfi(*weight[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+
+                const auto& w_arr = weight[lev]->array(mfi);
+                const auto& mask_arr = fine_mask.array(mfi);
+
+                for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+                for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+                for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+                {
+                    if(mask_arr(i,j,k) == 1) w_arr(i,j,k) = 0.0;
+                }
+            }
+        }
+
+        // Same layout as IterationState(): velocity, then pressure gradient
+        weights.push_back(weight[lev].get());
+        weights.push_back(weight[lev].get());
+    }
+    return weights;
+}
@@ -0,0 +1,193 @@
+#include <AMReX_MultiFab.H>
+
+#include <BCList.H>
+#include <boundary_conditions_F.H>
+
+using namespace amrex;
+
+BCList::BCList(const BoxArray& ba, const DistributionMapping& dm,
+               const Geometry& geom, int ngrow,
+               const Array<const IArrayBox*, 2*AMREX_SPACEDIM>& bc_type,
+               int probtype)
+    : m_faces(ba, dm)
+{
+    BL_PROFILE("BCList::BCList()");
+
+    const Box& domain = geom.Domain();
+
+    for(MFIter mfi(m_faces); mfi.isValid(); ++mfi)
+    {
+        const Box gbx = amrex::grow(mfi.validbox(), ngrow);
+        Faces& faces = m_faces[mfi];
+
+        for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
+        for(int side = 0; side < 2; side++)
+        {
+            const int f = 2 * dir + side;
+            const IArrayBox& bct = *bc_type[f];
+
+            // The BC arrays cover the layer of ghost cells next to their face
+            const Box cbx = gbx & bct.box();
+            if(!cbx.ok()) continue;
+
+            for(IntVect iv = cbx.smallEnd(); iv <= cbx.bigEnd(); cbx.next(iv))
+            {
+                Column c;
+                c.cell = iv;
+                c.type = bct(iv, 0);
+                c.vel[0] = c.vel[1] = c.vel[2] = 0.0;
+
+                if(c.type != pinf && c.type != pout && c.type != minf && c.type != nsw) continue;
+
+                if(c.type == minf || c.type == nsw)
+                {
+                    int bcv = bct(iv, 1);
+                    Real v[3];
+                    get_bc_vel(&bcv, v);
+
+                    if(c.type == minf)
+                    {
+                        // Only the normal component is prescribed
+                        c.vel[dir] = v[dir];
+
+                        // Poiseuille inflow profiles of the channel problems (31: xlo, 32: ylo, 33: zlo)
+                        if(side == 0 && probtype == 31 + dir)
+                        {
+                            const int t = (dir + 1) % 3;
+                            const Real s = (iv[t] + 0.5) / domain.length(t);
+                            c.vel[dir] = 6.0 * v[dir] * s * (1.0 - s);
+                        }
+                    }
+                    else
+                    {
+                        // Moving walls: no flow through the wall
+                        for(int n = 0; n < 3; n++) c.vel[n] = (n == dir) ? 0.0 : v[n];
+                    }
+                }
+
+                faces.face[f].push_back(c);
+                faces.empty = false;
+            }
+        }
+    }
+}
+
+bool BCList::compatible(const BoxArray& ba, const DistributionMapping& dm) const
+{
+    return ba == m_faces.boxArray() && dm == m_faces.DistributionMap();
+}
+
+void BCList::applyVelocity(MultiFab& vel, int extrap_dir_bcs) const
+{
+    BL_PROFILE("BCList::applyVelocity()");
+    AMREX_ASSERT(compatible(vel.boxArray(), vel.DistributionMap()) && vel.nComp() >= 3);
+
+    // Coefficients for quadratic extrapolation of the face value to the ghost cell
+    const Real c0 = 8.0 / 3.0;
+    const Real c1 = -2.0;
+    const Real c2 = 1.0 / 3.0;
+
+    // Whole boxes, not tiles: the columns of a box only touch its own fab
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for(MFIter mfi(vel, false); mfi.isValid(); ++mfi)
+    {
+        const Faces& faces = m_faces[mfi];
+        if(faces.empty) continue;
+
+        const Box& fbx = vel[mfi].box();
+        const auto& v = vel.array(mfi);
+
+        // Inflows and outflows first, then walls, so that walls win at edges and corners.
+        // The faces are done in order, as the edges of later faces use the ghost cells of
+        // earlier ones.
+        for(int f = 0; f < 2 * AMREX_SPACEDIM; f++)
+        {
+            // Outward step along the columns of this face
+            const IntVect out = (f % 2 == 0 ? -1 : 1) * IntVect::TheDimensionVector(f / 2);
+
+            for(const Column& c : faces.face[f])
+            {
+                if(c.type == nsw || !fbx.contains(c.cell)) continue;
+
+                const IntVect in = c.cell - out;
+                for(IntVect g = c.cell; fbx.contains(g); g += out)
+                for(int n = 0; n < 3; n++)
+                {
+                    v(g[0],g[1],g[2],n) = (c.type == minf) ? c.vel[n] : v(in[0],in[1],in[2],n);
+                }
+            }
+        }
+
+        for(int f = 0; f < 2 * AMREX_SPACEDIM; f++)
+        {
+            const IntVect out = (f % 2 == 0 ? -1 : 1) * IntVect::TheDimensionVector(f / 2);
+
+            for(const Column& c : faces.face[f])
+            {
+                if((c.type != nsw && c.type != minf) || !fbx.contains(c.cell)) continue;
+
+                if(c.type == nsw)
+                {
+                    for(IntVect g = c.cell; fbx.contains(g); g += out)
+                    for(int n = 0; n < 3; n++)
+                    {
+                        v(g[0],g[1],g[2],n) = c.vel[n];
+                    }
+                }
+
+                if(extrap_dir_bcs > 0)
+                {
+                    const IntVect& g = c.cell;
+                    const IntVect i1 = g - out;
+                    const IntVect i2 = i1 - out;
+                    for(int n = 0; n < 3; n++)
+                    {
+                        v(g[0],g[1],g[2],n) = c0 * v(g[0],g[1],g[2],n)
+                                            + c1 * v(i1[0],i1[1],i1[2],n)
+                                            + c2 * v(i2[0],i2[1],i2[2],n);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void BCList::applyScalar(MultiFab& s) const
+{
+    BL_PROFILE("BCList::applyScalar()");
+    AMREX_ASSERT(compatible(s.boxArray(), s.DistributionMap()));
+
+    const int ncomp = s.nComp();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for(MFIter mfi(s, false); mfi.isValid(); ++mfi)
+    {
+        const Faces& faces = m_faces[mfi];
+        if(faces.empty) continue;
+
+        const Box& fbx = s[mfi].box();
+        const auto& a = s.array(mfi);
+
+        // In order, so that edges and corners take the value of the nearest valid cell
+        for(int f = 0; f < 2 * AMREX_SPACEDIM; f++)
+        {
+            const IntVect out = (f % 2 == 0 ? -1 : 1) * IntVect::TheDimensionVector(f / 2);
+
+            for(const Column& c : faces.face[f])
+            {
+                if(!fbx.contains(c.cell)) continue;
+
+                const IntVect in = c.cell - out;
+                for(IntVect g = c.cell; fbx.contains(g); g += out)
+                for(int n = 0; n < ncomp; n++)
+                {
+                    a(g[0],g[1],g[2],n) = a(in[0],in[1],in[2],n);
+                }
+            }
+        }
+    }
+}
@@ -45,4 +45,20 @@ module bc
 
 contains
 
+   ! Velocity of BC bcv, zero if bcv is not a valid BC index
+   subroutine get_bc_vel(bcv, vel) bind(C)
+
+      integer(c_int), intent(in   ) :: bcv
+      real(rt),       intent(  out) :: vel(3)
+
+      vel = zero
+
+      if (bcv >= 1 .and. bcv <= dim_bc) then
+         vel(1) = bc_u(bcv)
+         vel(2) = bc_v(bcv)
+         vel(3) = bc_w(bcv)
+      end if
+
+   end subroutine get_bc_vel
+
 end module bc
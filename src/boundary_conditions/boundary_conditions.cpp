@@ -15,6 +15,9 @@
 namespace
 {
   incflo* incflo_for_fillpatching;
+
+  // Level of the data VelFillBox is called for
+  int fillpatch_lev = 0;
 }
 
 void set_ptr_to_incflo(incflo& incflo_for_fillpatching_in)
@@ -26,6 +29,8 @@ void set_ptr_to_incflo(incflo& incflo_for_fillpatching_in)
 //    CpuBndryFuncFab in amrex/Src/Base/AMReX_PhysBCFunct.H
 // We can't get around this so instead we create an incflo object
 //    and use that to access the quantities that aren't passed here.
+// Only used for the coarse data of two-level fills, the BCs of the data
+//    being filled are applied from the BC lists.
 inline void VelFillBox(Box const& bx, Array4<amrex::Real> const& dest, 
                        const int dcomp, const int numcomp,
                        GeometryData const& geom, const Real time_in, 
@@ -41,19 +46,7 @@ inline void VelFillBox(Box const& bx, Array4<amrex::Real> const& dest,
 
     const Box& domain = geom.Domain();
 
-    // This is a bit hack-y but does get us the right level 
-    int lev = 0;
-    while(lev < 20)
-    {
-       const Geometry& lev_geom = incflo_for_fillpatching->get_geom_ref(lev);
-       if (domain.length()[0] == (lev_geom.Domain()).length()[0]) 
-       {
-         break;
-       }
-       lev++;
-    }
-    if (lev == 20)
-        amrex::Abort("Reached lev = 20 in VelFillBox...");
+    const int lev = fillpatch_lev;
 
     // We are hard-wiring this fillpatch routine to define the Dirichlet values
     //    at the faces (not the ghost cell center)
@@ -75,6 +68,7 @@ inline void VelFillBox(Box const& bx, Array4<amrex::Real> const& dest,
     FArrayBox dest_fab(dest);
 
     set_velocity_bcs(&time, 
+                     dest_fab.loVect(), dest_fab.hiVect(),
                      dest_fab.dataPtr(), dest_fab.loVect(), dest_fab.hiVect(),
                      bc_ilo_ptr, bc_ihi_ptr, 
                      bc_jlo_ptr, bc_jhi_ptr, 
@@ -83,27 +77,42 @@ inline void VelFillBox(Box const& bx, Array4<amrex::Real> const& dest,
                      &nghost, &extrap_dir_bcs, &probtype);
 }
 
+// Physical BCs are applied after the fill, from the BC lists
+inline void NoFillBox(Box const& bx, Array4<amrex::Real> const& dest, 
+                      const int dcomp, const int numcomp,
+                      GeometryData const& geom, const Real time, 
+                      const BCRec* bcr, 
+                      const int bcomp, const int orig_comp)
+{
+}
+
 // Compute a new multifab by copying array from valid region and filling ghost cells
 // works for single level and 2-level cases (fill fine grid ghost by interpolating from coarse)
 void
 incflo::FillPatchVel(int lev, Real time, MultiFab& mf, int icomp, int ncomp)
 {
+    INCFLO_TIMER("FillPatchVel");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(icomp == 0 && ncomp == 3,
+                                     "FillPatchVel: must fill all 3 velocity components");
+
     // There aren't used for anything but need to be defined for the function call
     Vector<BCRec> bcs(3);
 
     // Hack so that ghost cells are not undefined
     mf.setDomainBndry(boundary_val, geom[lev]);
 
+    CpuBndryFuncFab nofill(NoFillBox);
+    PhysBCFunct<CpuBndryFuncFab> fphysbc(geom[lev], bcs, nofill);
+
     if (lev == 0)
     {
         Vector<MultiFab*> smf;
         Vector<Real> stime;
         GetDataVel(0, time, smf, stime);
 
-        CpuBndryFuncFab bfunc(VelFillBox);
-        PhysBCFunct<CpuBndryFuncFab> physbc(geom[lev], bcs, bfunc);
         amrex::FillPatchSingleLevel(mf, time, smf, stime, 0, icomp, ncomp,
-                                    geom[lev], physbc, 0);
+                                    geom[lev], fphysbc, 0);
     }
     else
     {
@@ -114,7 +123,7 @@ incflo::FillPatchVel(int lev, Real time, MultiFab& mf, int icomp, int ncomp)
 
         CpuBndryFuncFab bfunc(VelFillBox);
         PhysBCFunct<CpuBndryFuncFab> cphysbc(geom[lev-1],bcs,bfunc);
-        PhysBCFunct<CpuBndryFuncFab> fphysbc(geom[lev  ],bcs,bfunc);
+        fillpatch_lev = lev-1;
 
         Interpolater* mapper = &cell_cons_interp;
 
@@ -124,6 +133,90 @@ incflo::FillPatchVel(int lev, Real time, MultiFab& mf, int icomp, int ncomp)
                                   refRatio(lev-1), mapper, bcs, 0);
 
     }
+
+    // mf is not on the grids of the level when regridding
+    if (GetBCList(lev).compatible(mf.boxArray(), mf.DistributionMap()))
+    {
+        GetBCList(lev).applyVelocity(mf, 1);
+    }
+    else
+    {
+        MakeBCList(lev, mf.boxArray(), mf.DistributionMap(), mf.nGrow())->applyVelocity(mf, 1);
+    }
+}
+
+// Split-phase FillPatchVel: copy the valid data and start the ghost cell exchange.
+// Tiles which don't need ghost cells can be worked on before calling FillPatchVelFinish.
+// If the exchange can't be split (overlap_comm = 0, fine levels, interpolation in time),
+// this does a complete FillPatchVel instead and returns false.
+bool
+incflo::FillPatchVelStart(int lev, Real time, MultiFab& mf, int icomp, int ncomp)
+{
+    Vector<MultiFab*> smf;
+    Vector<Real> stime;
+    GetDataVel(lev, time, smf, stime);
+
+    if (overlap_comm == 0 || lev > 0 || smf.size() != 1 ||
+        mf.boxArray() != smf[0]->boxArray() ||
+        mf.DistributionMap() != smf[0]->DistributionMap())
+    {
+        FillPatchVel(lev, time, mf, icomp, ncomp);
+        return false;
+    }
+
+    INCFLO_TIMER("FillPatchVel");
+
+    // Hack so that ghost cells are not undefined
+    mf.setDomainBndry(boundary_val, geom[lev]);
+
+    // Same as FillPatchSingleLevel with a single source on the same grids
+    MultiFab::Copy(mf, *smf[0], 0, icomp, ncomp, 0);
+    mf.FillBoundary_nowait(icomp, ncomp, geom[lev].periodicity());
+
+    return true;
+}
+
+// Complete the exchange started in FillPatchVelStart and apply the physical BCs
+void
+incflo::FillPatchVelFinish(int lev, Real time, MultiFab& mf, int icomp, int ncomp)
+{
+    INCFLO_TIMER("FillPatchVel");
+
+    mf.FillBoundary_finish();
+
+    // FillPatchVelStart only splits the exchange for data on the grids of the level
+    GetBCList(lev).applyVelocity(mf, 1);
+}
+
+// BC lists of the grids of level lev, (re)built when the grids have changed
+const BCList&
+incflo::GetBCList(int lev)
+{
+    if (!bc_list[lev] || !bc_list[lev]->compatible(grids[lev], dmap[lev]))
+    {
+        bc_list[lev] = MakeBCList(lev, grids[lev], dmap[lev], nghost);
+    }
+    return *bc_list[lev];
+}
+
+std::unique_ptr<BCList>
+incflo::MakeBCList(int lev, const BoxArray& ba, const DistributionMapping& dm, int ngrow)
+{
+    Array<const IArrayBox*, 2*AMREX_SPACEDIM> bc_type = {bc_ilo[lev].get(), bc_ihi[lev].get(),
+                                                         bc_jlo[lev].get(), bc_jhi[lev].get(),
+                                                         bc_klo[lev].get(), bc_khi[lev].get()};
+
+    return std::unique_ptr<BCList>(new BCList(ba, dm, geom[lev], ngrow, bc_type, probtype));
+}
+
+bool
+incflo::DoTile(const MFIter& mfi, TilePass pass, int ngrow)
+{
+    if(pass == TilePass::all) return true;
+
+    const bool interior = mfi.validbox().contains(amrex::grow(mfi.tilebox(), ngrow));
+
+    return (pass == TilePass::interior) == interior;
 }
 
 // utility to copy in data from phi_old and/or phi_new into another multifab
@@ -164,25 +257,14 @@ void incflo::FillVelocityBC(Real time, int extrap_dir_bcs)
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
-        Box domain(geom[lev].Domain());
-
         // Hack so that ghost cells are not undefined
         vel[lev]->setDomainBndry(boundary_val, geom[lev]);
 
         vel[lev]->FillBoundary(geom[lev].periodicity());
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-        for(MFIter mfi(*vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            set_velocity_bcs(&time, 
-                             BL_TO_FORTRAN_ANYD((*vel[lev])[mfi]),
-                             bc_ilo[lev]->dataPtr(), bc_ihi[lev]->dataPtr(),
-                             bc_jlo[lev]->dataPtr(), bc_jhi[lev]->dataPtr(),
-                             bc_klo[lev]->dataPtr(), bc_khi[lev]->dataPtr(),
-                             domain.loVect(), domain.hiVect(),
-                             &nghost, &extrap_dir_bcs, &probtype);
-        }
+
+        // Only the boxes touching the physical boundaries have work to do
+        GetBCList(lev).applyVelocity(*vel[lev], extrap_dir_bcs);
+
         EB_set_covered(*vel[lev], covered_val);
         
         // Do this after as well as before to pick up terms that got updated in the call above
@@ -196,8 +278,6 @@ void incflo::FillScalarBC()
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
-        Box domain(geom[lev].Domain());
-        
         // Hack so that ghost cells are not undefined
          ro[lev]->setDomainBndry(boundary_val, geom[lev]);
         eta[lev]->setDomainBndry(boundary_val, geom[lev]);
@@ -207,27 +287,8 @@ void incflo::FillScalarBC()
         eta[lev]->FillBoundary(geom[lev].periodicity());
 
         // Fill all cell-centered arrays with first-order extrapolation at domain boundaries
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-        for(MFIter mfi(*ro[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            // Density
-            fill_bc0(BL_TO_FORTRAN_ANYD((*ro[lev])[mfi]),
-                     bc_ilo[lev]->dataPtr(), bc_ihi[lev]->dataPtr(),
-                     bc_jlo[lev]->dataPtr(), bc_jhi[lev]->dataPtr(),
-                     bc_klo[lev]->dataPtr(), bc_khi[lev]->dataPtr(),
-                     domain.loVect(), domain.hiVect(),
-                     &nghost);
-
-            // Viscosity
-            fill_bc0(BL_TO_FORTRAN_ANYD((*eta[lev])[mfi]),
-                     bc_ilo[lev]->dataPtr(), bc_ihi[lev]->dataPtr(),
-                     bc_jlo[lev]->dataPtr(), bc_jhi[lev]->dataPtr(),
-                     bc_klo[lev]->dataPtr(), bc_khi[lev]->dataPtr(),
-                     domain.loVect(), domain.hiVect(),
-                     &nghost);
-        }
+        GetBCList(lev).applyScalar(*ro[lev]);
+        GetBCList(lev).applyScalar(*eta[lev]);
     }
 }
 
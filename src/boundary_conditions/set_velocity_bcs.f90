@@ -1,7 +1,7 @@
 !
 !  This subroutine sets the BCs for the velocity components only.
 !
-subroutine set_velocity_bcs(time, &
+subroutine set_velocity_bcs(time, lo, hi, &
                             vel, ulo, uhi, &
                             bct_ilo, bct_ihi, &
                             bct_jlo, bct_jhi, &
@@ -20,7 +20,8 @@ subroutine set_velocity_bcs(time, &
    ! Time (necessary if we have time-dependent boundary conditions)
    real(ar),       intent(in   ) :: time
 
-   ! Array bounds
+   ! Region to fill (e.g. the grown tile box) and array bounds
+   integer(c_int), intent(in   ) ::  lo(3),  hi(3)
    integer(c_int), intent(in   ) :: ulo(3), uhi(3)
 
    ! This flag, if true, extrapolates Dirichlet bc's to the ghost cells rather than
@@ -63,21 +64,21 @@ subroutine set_velocity_bcs(time, &
    c1 = -2.0d0
    c2 = 1.0d0 / 3.0d0
 
-   nlft = max(0,domlo(1)-ulo(1))
-   nbot = max(0,domlo(2)-ulo(2))
-   ndwn = max(0,domlo(3)-ulo(3))
+   nlft = max(0,domlo(1)-lo(1))
+   nbot = max(0,domlo(2)-lo(2))
+   ndwn = max(0,domlo(3)-lo(3))
 
-   nrgt = max(0,uhi(1)-domhi(1))
-   ntop = max(0,uhi(2)-domhi(2))
-   nup  = max(0,uhi(3)-domhi(3))
+   nrgt = max(0,hi(1)-domhi(1))
+   ntop = max(0,hi(2)-domhi(2))
+   nup  = max(0,hi(3)-domhi(3))
 
 ! *******************************************************************
 ! First do just the pinf, pout and minf
 ! *******************************************************************
 
    if (nlft .gt. 0) then
-      do k = ulo(3), uhi(3)
-         do j = ulo(2), uhi(2)
+      do k = lo(3), hi(3)
+         do j = lo(2), hi(2)
 
             bcv = bct_ilo(j,k,2)
 
@@ -85,19 +86,19 @@ subroutine set_velocity_bcs(time, &
 
             case ( pinf_, pout_)
 
-               vel(ulo(1):domlo(1)-1,j,k,1) =  vel(domlo(1),j,k,1)
-               vel(ulo(1):domlo(1)-1,j,k,2) =  vel(domlo(1),j,k,2)
-               vel(ulo(1):domlo(1)-1,j,k,3) =  vel(domlo(1),j,k,3)
+               vel(lo(1):domlo(1)-1,j,k,1) =  vel(domlo(1),j,k,1)
+               vel(lo(1):domlo(1)-1,j,k,2) =  vel(domlo(1),j,k,2)
+               vel(lo(1):domlo(1)-1,j,k,3) =  vel(domlo(1),j,k,3)
 
             case ( minf_)
 
-               vel(ulo(1):domlo(1)-1,j,k,1) =  bc_u(bcv)
-               vel(ulo(1):domlo(1)-1,j,k,2) =  zero
-               vel(ulo(1):domlo(1)-1,j,k,3) =  zero
+               vel(lo(1):domlo(1)-1,j,k,1) =  bc_u(bcv)
+               vel(lo(1):domlo(1)-1,j,k,2) =  zero
+               vel(lo(1):domlo(1)-1,j,k,3) =  zero
 
                if (probtype == 31) then
                   y = (real(j,ar) + half) / (domhi(2) - domlo(2) + 1)
-                  vel(ulo(1):domlo(1)-1,j,k,1) =  6.0 * bc_u(bcv) * y * (one - y)
+                  vel(lo(1):domlo(1)-1,j,k,1) =  6.0 * bc_u(bcv) * y * (one - y)
                endif
 
             end select
@@ -108,8 +109,8 @@ subroutine set_velocity_bcs(time, &
 
    if (nrgt .gt. 0) then
 
-      do k = ulo(3),uhi(3)
-         do j = ulo(2),uhi(2)
+      do k = lo(3),hi(3)
+         do j = lo(2),hi(2)
 
             bcv = bct_ihi(j,k,2)
 
@@ -117,15 +118,15 @@ subroutine set_velocity_bcs(time, &
 
             case ( pinf_, pout_ )
 
-               vel(domhi(1)+1:uhi(1),j,k,1) =    vel(domhi(1),j,k,1)
-               vel(domhi(1)+1:uhi(1),j,k,2) =    vel(domhi(1),j,k,2)
-               vel(domhi(1)+1:uhi(1),j,k,3) =    vel(domhi(1),j,k,3)
+               vel(domhi(1)+1:hi(1),j,k,1) =    vel(domhi(1),j,k,1)
+               vel(domhi(1)+1:hi(1),j,k,2) =    vel(domhi(1),j,k,2)
+               vel(domhi(1)+1:hi(1),j,k,3) =    vel(domhi(1),j,k,3)
 
             case ( minf_ )
 
-               vel(domhi(1)+1:uhi(1),j,k,1) = bc_u(bcv)
-               vel(domhi(1)+1:uhi(1),j,k,2) = zero
-               vel(domhi(1)+1:uhi(1),j,k,3) = zero
+               vel(domhi(1)+1:hi(1),j,k,1) = bc_u(bcv)
+               vel(domhi(1)+1:hi(1),j,k,2) = zero
+               vel(domhi(1)+1:hi(1),j,k,3) = zero
 
             end select
 
@@ -135,8 +136,8 @@ subroutine set_velocity_bcs(time, &
 
    if (nbot .gt. 0) then
 
-      do k = ulo(3), uhi(3)
-         do i = ulo(1), uhi(1)
+      do k = lo(3), hi(3)
+         do i = lo(1), hi(1)
 
             bcv = bct_jlo(i,k,2)
 
@@ -144,19 +145,19 @@ subroutine set_velocity_bcs(time, &
 
             case ( pinf_, pout_)
 
-               vel(i,ulo(2):domlo(2)-1,k,1) =      vel(i,domlo(2),k,1)
-               vel(i,ulo(2):domlo(2)-1,k,2) =      vel(i,domlo(2),k,2)
-               vel(i,ulo(2):domlo(2)-1,k,3) =      vel(i,domlo(2),k,3)
+               vel(i,lo(2):domlo(2)-1,k,1) =      vel(i,domlo(2),k,1)
+               vel(i,lo(2):domlo(2)-1,k,2) =      vel(i,domlo(2),k,2)
+               vel(i,lo(2):domlo(2)-1,k,3) =      vel(i,domlo(2),k,3)
 
             case ( minf_ )
 
-               vel(i,ulo(2):domlo(2)-1,k,1) = zero
-               vel(i,ulo(2):domlo(2)-1,k,2) = bc_v(bcv)
-               vel(i,ulo(2):domlo(2)-1,k,3) = zero
+               vel(i,lo(2):domlo(2)-1,k,1) = zero
+               vel(i,lo(2):domlo(2)-1,k,2) = bc_v(bcv)
+               vel(i,lo(2):domlo(2)-1,k,3) = zero
 
                if (probtype == 32) then
                   z = (real(k,ar) + half) / (domhi(3) - domlo(3) + 1)
-                  vel(i,ulo(2):domlo(2)-1,k,2) =  6.0 * bc_v(bcv) * z * (one - z)
+                  vel(i,lo(2):domlo(2)-1,k,2) =  6.0 * bc_v(bcv) * z * (one - z)
                endif
 
             end select
@@ -167,8 +168,8 @@ subroutine set_velocity_bcs(time, &
 
    if (ntop .gt. 0) then
 
-      do k = ulo(3), uhi(3)
-         do i = ulo(1), uhi(1)
+      do k = lo(3), hi(3)
+         do i = lo(1), hi(1)
 
             bcv = bct_jhi(i,k,2)
 
@@ -176,15 +177,15 @@ subroutine set_velocity_bcs(time, &
 
             case ( pinf_, pout_ )
 
-               vel(i,domhi(2)+1:uhi(2),k,1) =      vel(i,domhi(2),k,1)
-               vel(i,domhi(2)+1:uhi(2),k,2) =      vel(i,domhi(2),k,2)
-               vel(i,domhi(2)+1:uhi(2),k,3) =      vel(i,domhi(2),k,3)
+               vel(i,domhi(2)+1:hi(2),k,1) =      vel(i,domhi(2),k,1)
+               vel(i,domhi(2)+1:hi(2),k,2) =      vel(i,domhi(2),k,2)
+               vel(i,domhi(2)+1:hi(2),k,3) =      vel(i,domhi(2),k,3)
 
             case ( minf_)
 
-               vel(i,domhi(2)+1:uhi(2),k,1) = zero
-               vel(i,domhi(2)+1:uhi(2),k,2) = bc_v(bcv)
-               vel(i,domhi(2)+1:uhi(2),k,3) = zero
+               vel(i,domhi(2)+1:hi(2),k,1) = zero
+               vel(i,domhi(2)+1:hi(2),k,2) = bc_v(bcv)
+               vel(i,domhi(2)+1:hi(2),k,3) = zero
 
             end select
 
@@ -194,8 +195,8 @@ subroutine set_velocity_bcs(time, &
 
    if (ndwn .gt. 0) then
 
-      do j = ulo(2), uhi(2)
-         do i = ulo(1), uhi(1)
+      do j = lo(2), hi(2)
+         do i = lo(1), hi(1)
 
             bcv = bct_klo(i,j,2)
 
@@ -203,19 +204,19 @@ subroutine set_velocity_bcs(time, &
 
             case ( pinf_, pout_ )
 
-               vel(i,j,ulo(3):domlo(3)-1,1) = vel(i,j,domlo(3),1)
-               vel(i,j,ulo(3):domlo(3)-1,2) = vel(i,j,domlo(3),2)
-               vel(i,j,ulo(3):domlo(3)-1,3) = vel(i,j,domlo(3),3)
+               vel(i,j,lo(3):domlo(3)-1,1) = vel(i,j,domlo(3),1)
+               vel(i,j,lo(3):domlo(3)-1,2) = vel(i,j,domlo(3),2)
+               vel(i,j,lo(3):domlo(3)-1,3) = vel(i,j,domlo(3),3)
 
             case ( minf_ )
 
-               vel(i,j,ulo(3):domlo(3)-1,1) = zero
-               vel(i,j,ulo(3):domlo(3)-1,2) = zero
-               vel(i,j,ulo(3):domlo(3)-1,3) = bc_w(bcv)
+               vel(i,j,lo(3):domlo(3)-1,1) = zero
+               vel(i,j,lo(3):domlo(3)-1,2) = zero
+               vel(i,j,lo(3):domlo(3)-1,3) = bc_w(bcv)
 
                if (probtype == 33) then
                   x = (real(i,ar) + half) / (domhi(1) - domlo(1) + 1)
-                  vel(i,j,ulo(3):domlo(3)-1,3) =  6.0 * bc_w(bcv) * x * (one - x)
+                  vel(i,j,lo(3):domlo(3)-1,3) =  6.0 * bc_w(bcv) * x * (one - x)
                endif
 
             end select
@@ -226,8 +227,8 @@ subroutine set_velocity_bcs(time, &
 
    if (nup .gt. 0) then
 
-      do j = ulo(2), uhi(2)
-         do i = ulo(1), uhi(1)
+      do j = lo(2), hi(2)
+         do i = lo(1), hi(1)
 
             bcv = bct_khi(i,j,2)
 
@@ -235,15 +236,15 @@ subroutine set_velocity_bcs(time, &
 
             case ( pinf_, pout_ )
 
-               vel(i,j,domhi(3)+1:uhi(3),1) = vel(i,j,domhi(3),1)
-               vel(i,j,domhi(3)+1:uhi(3),2) = vel(i,j,domhi(3),2)
-               vel(i,j,domhi(3)+1:uhi(3),3) = vel(i,j,domhi(3),3)
+               vel(i,j,domhi(3)+1:hi(3),1) = vel(i,j,domhi(3),1)
+               vel(i,j,domhi(3)+1:hi(3),2) = vel(i,j,domhi(3),2)
+               vel(i,j,domhi(3)+1:hi(3),3) = vel(i,j,domhi(3),3)
 
             case ( minf_ )
 
-               vel(i,j,domhi(3)+1:uhi(3),1) = zero
-               vel(i,j,domhi(3)+1:uhi(3),2) = zero
-               vel(i,j,domhi(3)+1:uhi(3),3) = bc_w(bcv)
+               vel(i,j,domhi(3)+1:hi(3),1) = zero
+               vel(i,j,domhi(3)+1:hi(3),2) = zero
+               vel(i,j,domhi(3)+1:hi(3),3) = bc_w(bcv)
 
             end select
 
@@ -256,8 +257,8 @@ subroutine set_velocity_bcs(time, &
 ! *******************************************************************
 
    if (nlft .gt. 0) then
-      do k = ulo(3), uhi(3)
-         do j = ulo(2), uhi(2)
+      do k = lo(3), hi(3)
+         do j = lo(2), hi(2)
 
             bcv = bct_ilo(j,k,2)
 
@@ -265,9 +266,9 @@ subroutine set_velocity_bcs(time, &
 
             case ( nsw_)
 
-               vel(ulo(1):domlo(1)-1,j,k,1) = zero
-               vel(ulo(1):domlo(1)-1,j,k,2) = bc_v(bcv)
-               vel(ulo(1):domlo(1)-1,j,k,3) = bc_w(bcv)
+               vel(lo(1):domlo(1)-1,j,k,1) = zero
+               vel(lo(1):domlo(1)-1,j,k,2) = bc_v(bcv)
+               vel(lo(1):domlo(1)-1,j,k,3) = bc_w(bcv)
 
             end select
 
@@ -286,8 +287,8 @@ subroutine set_velocity_bcs(time, &
 
    if (nrgt .gt. 0) then
 
-      do k = ulo(3),uhi(3)
-         do j = ulo(2),uhi(2)
+      do k = lo(3),hi(3)
+         do j = lo(2),hi(2)
 
             bcv = bct_ihi(j,k,2)
 
@@ -295,9 +296,9 @@ subroutine set_velocity_bcs(time, &
 
             case ( nsw_ )
 
-               vel(domhi(1)+1:uhi(1),j,k,1) = zero
-               vel(domhi(1)+1:uhi(1),j,k,2) = bc_v(bcv)
-               vel(domhi(1)+1:uhi(1),j,k,3) = bc_w(bcv)
+               vel(domhi(1)+1:hi(1),j,k,1) = zero
+               vel(domhi(1)+1:hi(1),j,k,2) = bc_v(bcv)
+               vel(domhi(1)+1:hi(1),j,k,3) = bc_w(bcv)
 
             end select
 
@@ -316,8 +317,8 @@ subroutine set_velocity_bcs(time, &
 
    if (nbot .gt. 0) then
 
-      do k = ulo(3), uhi(3)
-         do i = ulo(1), uhi(1)
+      do k = lo(3), hi(3)
+         do i = lo(1), hi(1)
 
             bcv = bct_jlo(i,k,2)
 
@@ -325,9 +326,9 @@ subroutine set_velocity_bcs(time, &
 
             case ( nsw_ )
 
-               vel(i,ulo(2):domlo(2)-1,k,1) = bc_u(bcv)
-               vel(i,ulo(2):domlo(2)-1,k,2) = zero
-               vel(i,ulo(2):domlo(2)-1,k,3) = bc_w(bcv)
+               vel(i,lo(2):domlo(2)-1,k,1) = bc_u(bcv)
+               vel(i,lo(2):domlo(2)-1,k,2) = zero
+               vel(i,lo(2):domlo(2)-1,k,3) = bc_w(bcv)
 
             end select
 
@@ -346,8 +347,8 @@ subroutine set_velocity_bcs(time, &
 
    if (ntop .gt. 0) then
 
-      do k = ulo(3), uhi(3)
-         do i = ulo(1), uhi(1)
+      do k = lo(3), hi(3)
+         do i = lo(1), hi(1)
 
             bcv = bct_jhi(i,k,2)
 
@@ -355,9 +356,9 @@ subroutine set_velocity_bcs(time, &
 
             case ( nsw_)
 
-               vel(i,domhi(2)+1:uhi(2),k,1) = bc_u(bcv)
-               vel(i,domhi(2)+1:uhi(2),k,2) = zero
-               vel(i,domhi(2)+1:uhi(2),k,3) = bc_w(bcv)
+               vel(i,domhi(2)+1:hi(2),k,1) = bc_u(bcv)
+               vel(i,domhi(2)+1:hi(2),k,2) = zero
+               vel(i,domhi(2)+1:hi(2),k,3) = bc_w(bcv)
 
             end select
 
@@ -376,8 +377,8 @@ subroutine set_velocity_bcs(time, &
 
    if (ndwn .gt. 0) then
 
-      do j = ulo(2), uhi(2)
-         do i = ulo(1), uhi(1)
+      do j = lo(2), hi(2)
+         do i = lo(1), hi(1)
 
             bcv = bct_klo(i,j,2)
 
@@ -385,9 +386,9 @@ subroutine set_velocity_bcs(time, &
 
             case ( nsw_ )
 
-               vel(i,j,ulo(3):domlo(3)-1,1) = bc_u(bcv)
-               vel(i,j,ulo(3):domlo(3)-1,2) = bc_v(bcv)
-               vel(i,j,ulo(3):domlo(3)-1,3) = zero
+               vel(i,j,lo(3):domlo(3)-1,1) = bc_u(bcv)
+               vel(i,j,lo(3):domlo(3)-1,2) = bc_v(bcv)
+               vel(i,j,lo(3):domlo(3)-1,3) = zero
 
             end select
 
@@ -406,8 +407,8 @@ subroutine set_velocity_bcs(time, &
 
    if (nup .gt. 0) then
 
-      do j = ulo(2), uhi(2)
-         do i = ulo(1), uhi(1)
+      do j = lo(2), hi(2)
+         do i = lo(1), hi(1)
 
             bcv = bct_khi(i,j,2)
 
@@ -415,9 +416,9 @@ subroutine set_velocity_bcs(time, &
 
             case ( nsw_ )
 
-               vel(i,j,domhi(3)+1:uhi(3),1) = bc_u(bcv)
-               vel(i,j,domhi(3)+1:uhi(3),2) = bc_v(bcv)
-               vel(i,j,domhi(3)+1:uhi(3),3) = zero
+               vel(i,j,domhi(3)+1:hi(3),1) = bc_u(bcv)
+               vel(i,j,domhi(3)+1:hi(3),2) = bc_v(bcv)
+               vel(i,j,domhi(3)+1:hi(3),3) = zero
 
             end select
 
@@ -5,6 +5,7 @@
 #include <AMReX_ParmParse.H>
 
 #include <MacProjection.H>
+#include <PhaseTimer.H>
 #include <boundary_conditions_F.H>
 #include <mac_F.H>
 #include <projection_F.H>
@@ -179,6 +180,7 @@ void MacProjection::apply_projection(Vector<std::unique_ptr<MultiFab>>& u,
                                      Real time, int steady_state)
 {
     BL_PROFILE("MacProjection::apply_projection()");
+    INCFLO_TIMER("MacProjection");
 
     if (verbose)
 	Print() << "MAC Projection:\n";
@@ -307,6 +309,9 @@ void MacProjection::set_velocity_bcs(int lev,
 	{
 		const Box& bx = (*m_divu[lev])[mfi].box();
 
+		// Nothing to do for boxes whose ghost cells (and faces) are all inside the domain
+		if(domain.contains(amrex::grow(bx, 1))) continue;
+
 		set_mac_velocity_bcs(&time, 
                              bx.loVect(),
 							 bx.hiVect(),
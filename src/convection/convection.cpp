@@ -12,8 +12,9 @@ void incflo::ComputeUGradU(Vector<std::unique_ptr<MultiFab>>& conv_in,
                            Real time)
 {
 	BL_PROFILE("incflo::ComputeUGradU");
+	INCFLO_TIMER("ComputeUGradU");
 
-    // Extrapolate velocity field to cell faces
+    // Extrapolate velocity field to cell faces (this takes the slopes from the scratch pool)
     ComputeVelocityAtFaces(vel_in, time);
 
     // Do projection on all AMR-level_ins in one shot
@@ -21,95 +22,142 @@ void incflo::ComputeUGradU(Vector<std::unique_ptr<MultiFab>>& conv_in,
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
-        Box domain(geom[lev].Domain());
+        ComputeConvectiveTerm(lev, *conv_in[lev], *vel_in[lev]);
+    }
+
+    ReleaseSlopes();
+}
+
+//
+// Take the slopes of all levels from the scratch pool, unless they are already held.
+// The slopes are only computed in the valid cells and exchanged by FillBoundary, so the
+// remaining ghost cells (domain boundaries, coarse-fine interfaces) are set to zero.
+//
+void incflo::AcquireSlopes()
+{
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        if(xslopes[lev]) continue;
+
+        xslopes[lev] = scratch.acquire(grids[lev], dmap[lev], AMREX_SPACEDIM, ng_slopes, *ebfactory[lev]);
+        yslopes[lev] = scratch.acquire(grids[lev], dmap[lev], AMREX_SPACEDIM, ng_slopes, *ebfactory[lev]);
+        zslopes[lev] = scratch.acquire(grids[lev], dmap[lev], AMREX_SPACEDIM, ng_slopes, *ebfactory[lev]);
+
+        xslopes[lev]->setBndry(0.);
+        yslopes[lev]->setBndry(0.);
+        zslopes[lev]->setBndry(0.);
+    }
+}
+
+void incflo::ReleaseSlopes()
+{
+    scratch.release(xslopes);
+    scratch.release(yslopes);
+    scratch.release(zslopes);
+}
+
+//
+// Compute the convective term u dot grad u on level lev from the cell-centred velocity,
+// its slopes and the (MAC-projected) face velocities
+//
+void incflo::ComputeConvectiveTerm(int lev, MultiFab& conv_in, MultiFab& vel_in)
+{
+	BL_PROFILE("incflo::ComputeConvectiveTerm");
 
-        // Get EB geometric info
-        Array< const MultiCutFab*,AMREX_SPACEDIM> areafrac;
-        Array< const MultiCutFab*,AMREX_SPACEDIM> facecent;
-        const amrex::MultiFab*                    volfrac;
-        const amrex::MultiCutFab*                 bndrycent;
+    Box domain(geom[lev].Domain());
 
-        areafrac  =   ebfactory[lev] -> getAreaFrac();
-        facecent  =   ebfactory[lev] -> getFaceCent();
-        volfrac   = &(ebfactory[lev] -> getVolFrac());
-        bndrycent = &(ebfactory[lev] -> getBndryCent());
+    // Get EB geometric info
+    Array< const MultiCutFab*,AMREX_SPACEDIM> areafrac;
+    Array< const MultiCutFab*,AMREX_SPACEDIM> facecent;
+    const amrex::MultiFab*                    volfrac;
+    const amrex::MultiCutFab*                 bndrycent;
+
+    areafrac  =   ebfactory[lev] -> getAreaFrac();
+    facecent  =   ebfactory[lev] -> getFaceCent();
+    volfrac   = &(ebfactory[lev] -> getVolFrac());
+    bndrycent = &(ebfactory[lev] -> getBndryCent());
+
+    const EBTiles& tiles = GetEBTiles(lev);
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for(MFIter mfi(*vel_in[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            // Tilebox
-            Box bx = mfi.tilebox();
+    for(MFIter mfi(vel_in, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        // Tilebox
+        Box bx = mfi.tilebox();
+
+        const EBFArrayBox& vel_in_fab = static_cast<EBFArrayBox const&>(vel_in[mfi]);
+        const EBCellFlagFab& flags = vel_in_fab.getEBCellFlagFab();
 
-            // this is to check efficiently if this tile contains any eb stuff
-            const EBFArrayBox& vel_in_fab = static_cast<EBFArrayBox const&>((*vel_in[lev])[mfi]);
-            const EBCellFlagFab& flags = vel_in_fab.getEBCellFlagFab();
+        if(tiles.type(mfi, 0) == FabType::covered)
+        {
+            // If tile is completely covered by EB geometry, set slopes
+            // value to some very large number so we know if
+            // we accidentaly use these covered slopes later in calculations
+            conv_in.setVal(1.2345e300, bx, 0, AMREX_SPACEDIM);
+        }
+        else
+        {
+            // Cells whose stencil only sees regular cells take the regular kernel. Tiles near
+            // the EB get the conservative form of compute_ugradu_eb, without -u div(u_mac), so
+            // that their regular and EB parts use the same discretisation.
+            const int conservative = (tiles.type(mfi, nghost) != FabType::regular);
 
-            if(flags.getType(amrex::grow(bx, 0)) == FabType::covered)
+            for(const Box& rbx : tiles.regularParts(mfi))
             {
-                // If tile is completely covered by EB geometry, set slopes
-                // value to some very large number so we know if
-                // we accidentaly use these covered slopes later in calculations
-                conv_in[lev]->setVal(1.2345e300, bx, 0, AMREX_SPACEDIM);
+                compute_ugradu(BL_TO_FORTRAN_BOX(rbx),
+                               BL_TO_FORTRAN_ANYD(conv_in[mfi]),
+                               BL_TO_FORTRAN_ANYD(vel_in[mfi]),
+                               BL_TO_FORTRAN_ANYD((*m_u_mac[lev])[mfi]),
+                               BL_TO_FORTRAN_ANYD((*m_v_mac[lev])[mfi]),
+                               BL_TO_FORTRAN_ANYD((*m_w_mac[lev])[mfi]),
+                               (*xslopes[lev])[mfi].dataPtr(),
+                               (*yslopes[lev])[mfi].dataPtr(),
+                               BL_TO_FORTRAN_ANYD((*zslopes[lev])[mfi]),
+                               domain.loVect(), domain.hiVect(),
+                               bc_ilo[lev]->dataPtr(),
+                               bc_ihi[lev]->dataPtr(),
+                               bc_jlo[lev]->dataPtr(),
+                               bc_jhi[lev]->dataPtr(),
+                               bc_klo[lev]->dataPtr(),
+                               bc_khi[lev]->dataPtr(),
+                               geom[lev].CellSize(), &nghost, &conservative);
             }
-            else
+
+            for(const Box& ebx : tiles.ebParts(mfi))
             {
-                // No cut cells in tile + nghost-cell witdh halo -> use non-eb routine
-                if(flags.getType(amrex::grow(bx, nghost)) == FabType::regular)
-                {
-                    compute_ugradu(BL_TO_FORTRAN_BOX(bx),
-                                   BL_TO_FORTRAN_ANYD((*conv_in[lev])[mfi]),
-                                   BL_TO_FORTRAN_ANYD((*vel_in[lev])[mfi]),
-                                   BL_TO_FORTRAN_ANYD((*m_u_mac[lev])[mfi]),
-                                   BL_TO_FORTRAN_ANYD((*m_v_mac[lev])[mfi]),
-                                   BL_TO_FORTRAN_ANYD((*m_w_mac[lev])[mfi]),
-                                   (*xslopes[lev])[mfi].dataPtr(),
-                                   (*yslopes[lev])[mfi].dataPtr(),
-                                   BL_TO_FORTRAN_ANYD((*zslopes[lev])[mfi]),
-                                   domain.loVect(), domain.hiVect(),
-                                   bc_ilo[lev]->dataPtr(),
-                                   bc_ihi[lev]->dataPtr(),
-                                   bc_jlo[lev]->dataPtr(),
-                                   bc_jhi[lev]->dataPtr(),
-                                   bc_klo[lev]->dataPtr(),
-                                   bc_khi[lev]->dataPtr(),
-                                   geom[lev].CellSize(), &nghost);
-                }
-                else
-                {
-                    compute_ugradu_eb(BL_TO_FORTRAN_BOX(bx),
-                                      BL_TO_FORTRAN_ANYD((*conv_in[lev])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*vel_in[lev])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*m_u_mac[lev])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*m_v_mac[lev])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*m_w_mac[lev])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*areafrac[0])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*areafrac[1])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*areafrac[2])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*facecent[0])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*facecent[1])[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*facecent[2])[mfi]),
-                                      BL_TO_FORTRAN_ANYD(flags),
-                                      BL_TO_FORTRAN_ANYD((*volfrac)[mfi]),
-                                      BL_TO_FORTRAN_ANYD((*bndrycent)[mfi]),
-                                      (*xslopes[lev])[mfi].dataPtr(),
-                                      (*yslopes[lev])[mfi].dataPtr(),
-                                      BL_TO_FORTRAN_ANYD((*zslopes[lev])[mfi]),
-                                      domain.loVect(),
-                                      domain.hiVect(),
-                                      bc_ilo[lev]->dataPtr(),
-                                      bc_ihi[lev]->dataPtr(),
-                                      bc_jlo[lev]->dataPtr(),
-                                      bc_jhi[lev]->dataPtr(),
-                                      bc_klo[lev]->dataPtr(),
-                                      bc_khi[lev]->dataPtr(),
-                                      geom[lev].CellSize(),
-                                      &nghost);
-                }
+                compute_ugradu_eb(BL_TO_FORTRAN_BOX(ebx),
+                                  BL_TO_FORTRAN_ANYD(conv_in[mfi]),
+                                  BL_TO_FORTRAN_ANYD(vel_in[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*m_u_mac[lev])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*m_v_mac[lev])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*m_w_mac[lev])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*areafrac[0])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*areafrac[1])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*areafrac[2])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*facecent[0])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*facecent[1])[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*facecent[2])[mfi]),
+                                  BL_TO_FORTRAN_ANYD(flags),
+                                  BL_TO_FORTRAN_ANYD((*volfrac)[mfi]),
+                                  BL_TO_FORTRAN_ANYD((*bndrycent)[mfi]),
+                                  (*xslopes[lev])[mfi].dataPtr(),
+                                  (*yslopes[lev])[mfi].dataPtr(),
+                                  BL_TO_FORTRAN_ANYD((*zslopes[lev])[mfi]),
+                                  domain.loVect(),
+                                  domain.hiVect(),
+                                  bc_ilo[lev]->dataPtr(),
+                                  bc_ihi[lev]->dataPtr(),
+                                  bc_jlo[lev]->dataPtr(),
+                                  bc_jhi[lev]->dataPtr(),
+                                  bc_klo[lev]->dataPtr(),
+                                  bc_khi[lev]->dataPtr(),
+                                  geom[lev].CellSize(),
+                                  &nghost);
             }
         }
-	}
+    }
 }
 
 //
@@ -118,70 +166,193 @@ void incflo::ComputeUGradU(Vector<std::unique_ptr<MultiFab>>& conv_in,
 void incflo::ComputeVelocityAtFaces(Vector<std::unique_ptr<MultiFab>>& vel_in, Real time)
 {
 	BL_PROFILE("incflo::ComputeVelocityAtFaces");
+	INCFLO_TIMER("ComputeVelocityAtFaces");
+
+    AcquireSlopes();
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
         Box domain(geom[lev].Domain());
 
         // State with ghost cells
-        MultiFab Sborder(grids[lev], dmap[lev], vel[lev]->nComp(), nghost,
-                         MFInfo(), *ebfactory[lev]);
-        FillPatchVel(lev, time, Sborder, 0, Sborder.nComp());
+        std::unique_ptr<MultiFab> Sborder_ptr = scratch.acquire(grids[lev], dmap[lev], vel[lev]->nComp(),
+                                                                nghost, *ebfactory[lev]);
+        MultiFab& Sborder = *Sborder_ptr;
 
-        // Compute the slopes
-        ComputeVelocitySlopes(lev, Sborder);
+        if(FillPatchVelStart(lev, time, Sborder, 0, Sborder.nComp()))
+        {
+            // Slopes in the interior tiles while the ghost cells are exchanged. The covered
+            // cells are only set afterwards, as the physical BCs must see the same valid data
+            // as in a complete FillPatchVel; the slopes don't depend on the covered values
+            // (one-sided differences with a covered neighbour are zero).
+            ComputeVelocitySlopes(lev, Sborder, TilePass::interior);
+            FillPatchVelFinish(lev, time, Sborder, 0, Sborder.nComp());
+            EB_set_covered(Sborder, covered_val);
+            ComputeVelocitySlopes(lev, Sborder, TilePass::boundary);
+
+            xslopes[lev]->FillBoundary_nowait(geom[lev].periodicity());
+            yslopes[lev]->FillBoundary_nowait(geom[lev].periodicity());
+            zslopes[lev]->FillBoundary_nowait(geom[lev].periodicity());
+
+            // Copy each FAB back from Sborder into the vel array, complete with filled ghost cells
+            MultiFab::Copy (*vel_in[lev], Sborder, 0, 0, vel_in[lev]->nComp(), vel_in[lev]->nGrow());
+
+            // Face velocities in the interior tiles while the slopes are exchanged
+            UpwindVelocityToFaces(lev, TilePass::interior);
+
+            xslopes[lev]->FillBoundary_finish();
+            yslopes[lev]->FillBoundary_finish();
+            zslopes[lev]->FillBoundary_finish();
+
+            UpwindVelocityToFaces(lev, TilePass::boundary);
+        }
+        else
+        {
+            // Compute the slopes
+            ComputeVelocitySlopes(lev, Sborder);
 
-        // Copy each FAB back from Sborder into the vel array, complete with filled ghost cells
-        MultiFab::Copy (*vel_in[lev], Sborder, 0, 0, vel_in[lev]->nComp(), vel_in[lev]->nGrow());
+            // Copy each FAB back from Sborder into the vel array, complete with filled ghost cells
+            MultiFab::Copy (*vel_in[lev], Sborder, 0, 0, vel_in[lev]->nComp(), vel_in[lev]->nGrow());
 
-        // Get EB geometric info
-        Array<const MultiCutFab*, AMREX_SPACEDIM> areafrac;
-        areafrac = ebfactory[lev]->getAreaFrac();
+            // Then compute velocity at faces
+            UpwindVelocityToFaces(lev);
+        }
+
+        scratch.release(std::move(Sborder_ptr));
+    }
+}
+
+//
+// Upwind the cell-centred velocity on level lev to the cell faces, using the slopes
+// computed in ComputeVelocitySlopes. Only the tiles in the given pass are done.
+//
+void incflo::UpwindVelocityToFaces(int lev, TilePass pass)
+{
+	BL_PROFILE("incflo::UpwindVelocityToFaces");
+
+    // Get EB geometric info
+    Array<const MultiCutFab*, AMREX_SPACEDIM> areafrac;
+    areafrac = ebfactory[lev]->getAreaFrac();
+
+    const EBTiles& tiles = GetEBTiles(lev);
 
-    // Then compute velocity at faces
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for(MFIter mfi(Sborder, TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            // Tilebox
-            Box bx = mfi.tilebox();
-            Box ubx = mfi.tilebox(e_x);
-            Box vbx = mfi.tilebox(e_y);
-            Box wbx = mfi.tilebox(e_z);
+    for(MFIter mfi(*vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        // Faces use the cells (and slopes) on either side
+        if(!DoTile(mfi, pass, 1)) continue;
 
-            // this is to check efficiently if this tile contains any eb stuff
-            const EBFArrayBox& vel_in_fab = static_cast<EBFArrayBox const&>(Sborder[mfi]);
-            const EBCellFlagFab& flags = vel_in_fab.getEBCellFlagFab();
+        // Tilebox
+        Box bx = mfi.tilebox();
+        Box ubx = mfi.tilebox(e_x);
+        Box vbx = mfi.tilebox(e_y);
+        Box wbx = mfi.tilebox(e_z);
 
-            Real small_vel = 1.e-10;
-            Real  huge_vel = 1.e100;
+        Real small_vel = 1.e-10;
+        Real  huge_vel = 1.e100;
 
-            // Cell-centered velocity
-            const auto& ccvel_fab = vel[lev]->array(mfi);
+        // Cell-centered velocity
+        const auto& ccvel_fab = vel[lev]->array(mfi);
 
-            // Cell-centered slopes
-            const auto& xslopes_fab = (xslopes[lev])->array(mfi);
-            const auto& yslopes_fab = (yslopes[lev])->array(mfi);
-            const auto& zslopes_fab = (zslopes[lev])->array(mfi);
+        // Cell-centered slopes
+        const auto& xslopes_fab = (xslopes[lev])->array(mfi);
+        const auto& yslopes_fab = (yslopes[lev])->array(mfi);
+        const auto& zslopes_fab = (zslopes[lev])->array(mfi);
 
-            // Face-centered velocity components
-            const auto& umac_fab = (m_u_mac[lev])->array(mfi);
-            const auto& vmac_fab = (m_v_mac[lev])->array(mfi);
-            const auto& wmac_fab = (m_w_mac[lev])->array(mfi);
+        // Face-centered velocity components
+        const auto& umac_fab = (m_u_mac[lev])->array(mfi);
+        const auto& vmac_fab = (m_v_mac[lev])->array(mfi);
+        const auto& wmac_fab = (m_w_mac[lev])->array(mfi);
 
-            if(flags.getType(amrex::grow(bx, 0)) == FabType::covered)
+        if(tiles.type(mfi, 0) == FabType::covered)
+        {
+            m_u_mac[lev]->setVal(1.2345e300, ubx, 0, 1);
+            m_v_mac[lev]->setVal(1.2345e300, vbx, 0, 1);
+            m_w_mac[lev]->setVal(1.2345e300, wbx, 0, 1);
+        }
+        else if(tiles.type(mfi, 1) == FabType::regular)
+        {
+            // No cut cells in tile + 1-cell witdh halo -> use non-eb routine
+            AMREX_HOST_DEVICE_FOR_3D(ubx, i, j, k,
             {
-                m_u_mac[lev]->setVal(1.2345e300, ubx, 0, 1);
-                m_v_mac[lev]->setVal(1.2345e300, vbx, 0, 1);
-                m_w_mac[lev]->setVal(1.2345e300, wbx, 0, 1);
-            }
-            else if(flags.getType(amrex::grow(bx, 1)) == FabType::regular)
+                // X-faces
+                Real upls     = ccvel_fab(i  ,j,k,0) - 0.5 * xslopes_fab(i  ,j,k,0);
+                Real umns     = ccvel_fab(i-1,j,k,0) + 0.5 * xslopes_fab(i-1,j,k,0);
+                if ( umns < 0.0 && upls > 0.0 )
+                {
+                    umac_fab(i,j,k) = 0.0;
+                }
+                else
+                {
+                    Real avg = 0.5 * ( upls + umns );
+                    if (std::abs(avg) <  small_vel)
+                        umac_fab(i,j,k) = 0.0;
+                    else if (avg >= 0)
+                        umac_fab(i,j,k) = umns;
+                    else
+                        umac_fab(i,j,k) = upls;
+                }
+            });
+
+            AMREX_HOST_DEVICE_FOR_3D(vbx, i, j, k,
+            {
+                // Y-faces
+                Real upls     = ccvel_fab(i,j  ,k,1) - 0.5 * yslopes_fab(i,j  ,k,1);
+                Real umns     = ccvel_fab(i,j-1,k,1) + 0.5 * yslopes_fab(i,j-1,k,1);
+                if ( umns < 0.0 && upls > 0.0 )
+                {
+                    vmac_fab(i,j,k) = 0.0;
+                }
+                else
+                {
+                    Real avg = 0.5 * ( upls + umns );
+                    if (std::abs(avg) <  small_vel)
+                        vmac_fab(i,j,k) = 0.0;
+                    else if (avg >= 0)
+                        vmac_fab(i,j,k) = umns;
+                    else
+                        vmac_fab(i,j,k) = upls;
+                }
+            });
+
+            AMREX_HOST_DEVICE_FOR_3D(wbx, i, j, k,
+            {
+                // Z-faces
+                Real upls     = ccvel_fab(i,j,k  ,2) - 0.5 * zslopes_fab(i,j,k  ,2);
+                Real umns     = ccvel_fab(i,j,k-1,2) + 0.5 * zslopes_fab(i,j,k-1,2);
+                if ( umns < 0.0 && upls > 0.0 )
+                {
+                    wmac_fab(i,j,k) = 0.0;
+                }
+                else
+                {
+                    Real avg = 0.5 * ( upls + umns );
+                    if ( std::abs(avg) <  small_vel)
+                        wmac_fab(i,j,k) = 0.0;
+                    else if (avg >= 0)
+                        wmac_fab(i,j,k) = umns;
+                    else
+                        wmac_fab(i,j,k) = upls;
+                }
+            });
+
+        }
+        else
+        {
+
+            // Face-centered areas
+            const auto& ax_fab = areafrac[0]->array(mfi);
+            const auto& ay_fab = areafrac[1]->array(mfi);
+            const auto& az_fab = areafrac[2]->array(mfi);
+
+            // This FAB has cut cells
+            AMREX_HOST_DEVICE_FOR_3D(ubx, i, j, k,
             {
-                // No cut cells in tile + 1-cell witdh halo -> use non-eb routine
-                AMREX_HOST_DEVICE_FOR_3D(ubx, i, j, k,
+                // X-faces
+                if (ax_fab(i,j,k) > 0.0)
                 {
-                    // X-faces
                     Real upls     = ccvel_fab(i  ,j,k,0) - 0.5 * xslopes_fab(i  ,j,k,0);
                     Real umns     = ccvel_fab(i-1,j,k,0) + 0.5 * xslopes_fab(i-1,j,k,0);
                     if ( umns < 0.0 && upls > 0.0 )
@@ -198,11 +369,18 @@ void incflo::ComputeVelocityAtFaces(Vector<std::unique_ptr<MultiFab>>& vel_in, R
                         else
                             umac_fab(i,j,k) = upls;
                     }
-                });
+                }
+                else
+                {
+                    umac_fab(i,j,k) = huge_vel;
+                }
+            });
 
-                AMREX_HOST_DEVICE_FOR_3D(vbx, i, j, k,
+            AMREX_HOST_DEVICE_FOR_3D(vbx, i, j, k,
+            {
+                // Y-faces
+                if (ay_fab(i,j,k) > 0.0)
                 {
-                    // Y-faces
                     Real upls     = ccvel_fab(i,j  ,k,1) - 0.5 * yslopes_fab(i,j  ,k,1);
                     Real umns     = ccvel_fab(i,j-1,k,1) + 0.5 * yslopes_fab(i,j-1,k,1);
                     if ( umns < 0.0 && upls > 0.0 )
@@ -212,158 +390,82 @@ void incflo::ComputeVelocityAtFaces(Vector<std::unique_ptr<MultiFab>>& vel_in, R
                     else
                     {
                         Real avg = 0.5 * ( upls + umns );
-                        if (std::abs(avg) <  small_vel)
+                        if ( std::abs(avg) <  small_vel)
                             vmac_fab(i,j,k) = 0.0;
                         else if (avg >= 0)
                             vmac_fab(i,j,k) = umns;
                         else
                             vmac_fab(i,j,k) = upls;
                     }
-                });
+                }
+                else
+                {
+                    vmac_fab(i,j,k) = huge_vel;
+                }
+            });
 
-                AMREX_HOST_DEVICE_FOR_3D(wbx, i, j, k,
+            AMREX_HOST_DEVICE_FOR_3D(wbx, i, j, k,
+            {
+                // Z-faces
+                if (az_fab(i,j,k) > 0.0)
                 {
-                    // Z-faces
-                    Real upls     = ccvel_fab(i,j,k  ,2) - 0.5 * zslopes_fab(i,j,k  ,2);
-                    Real umns     = ccvel_fab(i,j,k-1,2) + 0.5 * zslopes_fab(i,j,k-1,2);
-                    if ( umns < 0.0 && upls > 0.0 )
-                    {
+                   Real upls     = ccvel_fab(i,j,k  ,2) - 0.5 * zslopes_fab(i,j,k  ,2);
+                   Real umns     = ccvel_fab(i,j,k-1,2) + 0.5 * zslopes_fab(i,j,k-1,2);
+                   if ( umns < 0.0 && upls > 0.0 )
+                   {
                         wmac_fab(i,j,k) = 0.0;
-                    }
-                    else
-                    {
+                   }
+                   else
+                   {
                         Real avg = 0.5 * ( upls + umns );
-                        if ( std::abs(avg) <  small_vel)
+                        if (std::abs(avg) <  small_vel)
                             wmac_fab(i,j,k) = 0.0;
                         else if (avg >= 0)
                             wmac_fab(i,j,k) = umns;
                         else
                             wmac_fab(i,j,k) = upls;
-                    }
-                });
-
-            }
-            else
-            {
-
-                // Face-centered areas
-                const auto& ax_fab = areafrac[0]->array(mfi);
-                const auto& ay_fab = areafrac[1]->array(mfi);
-                const auto& az_fab = areafrac[2]->array(mfi);
-
-                // This FAB has cut cells
-                AMREX_HOST_DEVICE_FOR_3D(ubx, i, j, k,
-                {
-                    // X-faces
-                    if (ax_fab(i,j,k) > 0.0)
-                    {
-                        Real upls     = ccvel_fab(i  ,j,k,0) - 0.5 * xslopes_fab(i  ,j,k,0);
-                        Real umns     = ccvel_fab(i-1,j,k,0) + 0.5 * xslopes_fab(i-1,j,k,0);
-                        if ( umns < 0.0 && upls > 0.0 )
-                        {
-                            umac_fab(i,j,k) = 0.0;
-                        }
-                        else
-                        {
-                            Real avg = 0.5 * ( upls + umns );
-                            if (std::abs(avg) <  small_vel)
-                                umac_fab(i,j,k) = 0.0;
-                            else if (avg >= 0)
-                                umac_fab(i,j,k) = umns;
-                            else
-                                umac_fab(i,j,k) = upls;
-                        }
-                    }
-                    else
-                    {
-                        umac_fab(i,j,k) = huge_vel;
-                    }
-                });
-
-                AMREX_HOST_DEVICE_FOR_3D(vbx, i, j, k,
-                {
-                    // Y-faces
-                    if (ay_fab(i,j,k) > 0.0)
-                    {
-                        Real upls     = ccvel_fab(i,j  ,k,1) - 0.5 * yslopes_fab(i,j  ,k,1);
-                        Real umns     = ccvel_fab(i,j-1,k,1) + 0.5 * yslopes_fab(i,j-1,k,1);
-                        if ( umns < 0.0 && upls > 0.0 )
-                        {
-                            vmac_fab(i,j,k) = 0.0;
-                        }
-                        else
-                        {
-                            Real avg = 0.5 * ( upls + umns );
-                            if ( std::abs(avg) <  small_vel)
-                                vmac_fab(i,j,k) = 0.0;
-                            else if (avg >= 0)
-                                vmac_fab(i,j,k) = umns;
-                            else
-                                vmac_fab(i,j,k) = upls;
-                        }
-                    }
-                    else
-                    {
-                        vmac_fab(i,j,k) = huge_vel;
-                    }
-                });
-
-                AMREX_HOST_DEVICE_FOR_3D(wbx, i, j, k,
+                   }
+                }
+                else
                 {
-                    // Z-faces
-                    if (az_fab(i,j,k) > 0.0)
-                    {
-                       Real upls     = ccvel_fab(i,j,k  ,2) - 0.5 * zslopes_fab(i,j,k  ,2);
-                       Real umns     = ccvel_fab(i,j,k-1,2) + 0.5 * zslopes_fab(i,j,k-1,2);
-                       if ( umns < 0.0 && upls > 0.0 )
-                       {
-                            wmac_fab(i,j,k) = 0.0;
-                       }
-                       else
-                       {
-                            Real avg = 0.5 * ( upls + umns );
-                            if (std::abs(avg) <  small_vel)
-                                wmac_fab(i,j,k) = 0.0;
-                            else if (avg >= 0)
-                                wmac_fab(i,j,k) = umns;
-                            else
-                                wmac_fab(i,j,k) = upls;
-                       }
-                    }
-                    else
-                    {
-                        wmac_fab(i,j,k) = huge_vel;
-                    }
-                });
+                    wmac_fab(i,j,k) = huge_vel;
+                }
+            });
 
-            } // Cut cells
-        } // MFIter
-    } // Levels
+        } // Cut cells
+    } // MFIter
 }
 //
 // Compute the slopes of each velocity component in all three directions.
+// With pass = TilePass::all, this also sets the covered cells of Sborder and fills the
+// ghost cells of the slopes. Otherwise that is up to the caller.
 //
-void incflo::ComputeVelocitySlopes(int lev, MultiFab& Sborder)
+void incflo::ComputeVelocitySlopes(int lev, MultiFab& Sborder, TilePass pass)
 {
 	BL_PROFILE("incflo::ComputeVelocitySlopes");
+	INCFLO_TIMER("ComputeVelocitySlopes");
 
-    EB_set_covered(Sborder, covered_val);
+    if(pass == TilePass::all)
+        EB_set_covered(Sborder, covered_val);
 
 	Box domain(geom[lev].Domain());
 
+    const EBTiles& tiles = GetEBTiles(lev);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
 	for(MFIter mfi(Sborder, TilingIfNotGPU()); mfi.isValid(); ++mfi)
 	{
+		if(!DoTile(mfi, pass, 1)) continue;
+
 		// Tilebox
 		Box bx = mfi.tilebox();
 
-		// this is to check efficiently if this tile contains any eb stuff
 		const EBFArrayBox& vel_in_fab = static_cast<EBFArrayBox const&>(Sborder[mfi]);
 		const EBCellFlagFab& flags = vel_in_fab.getEBCellFlagFab();
 
-		if(flags.getType(amrex::grow(bx, 0)) == FabType::covered)
+		if(tiles.type(mfi, 0) == FabType::covered)
 		{
 			// If tile is completely covered by EB geometry, set slopes
 			// value to some very large number so we know if
@@ -382,7 +484,7 @@ void incflo::ComputeVelocitySlopes(int lev, MultiFab& Sborder)
             int ncomp = Sborder.nComp();
 
 			// No cut cells in tile + 1-cell witdh halo -> use non-eb routine
-			if(flags.getType(amrex::grow(bx, 1)) == FabType::regular)
+			if(tiles.type(mfi, 1) == FabType::regular)
 			{
                 AMREX_HOST_DEVICE_FOR_4D(bx, ncomp, i, j, k, dir,
                 {
@@ -544,8 +646,11 @@ void incflo::ComputeVelocitySlopes(int lev, MultiFab& Sborder)
 		}
 	}
 
-	xslopes[lev]->FillBoundary(geom[lev].periodicity());
-	yslopes[lev]->FillBoundary(geom[lev].periodicity());
-	zslopes[lev]->FillBoundary(geom[lev].periodicity());
+    if(pass == TilePass::all)
+    {
+        xslopes[lev]->FillBoundary(geom[lev].periodicity());
+        yslopes[lev]->FillBoundary(geom[lev].periodicity());
+        zslopes[lev]->FillBoundary(geom[lev].periodicity());
+    }
 }
 
@@ -33,7 +33,7 @@ contains
                              domlo, domhi, &
                              bc_ilo_type, bc_ihi_type, &
                              bc_jlo_type, bc_jhi_type, &
-                             bc_klo_type, bc_khi_type, dx, ng) bind(C)
+                             bc_klo_type, bc_khi_type, dx, ng, conservative) bind(C)
 
       ! Tile bounds
       integer(c_int),  intent(in   ) :: lo(3),  hi(3)
@@ -47,6 +47,10 @@ contains
       integer(c_int),  intent(in   ) :: wlo(3), whi(3)
       integer(c_int),  intent(in   ) :: domlo(3), domhi(3), ng
 
+      ! If 1, return div(u^MAC u^cc) only, i.e. the form of compute_ugradu_eb in the
+      ! cells which only have regular neighbours. Used for the regular parts of EB tiles.
+      integer(c_int),  intent(in   ) :: conservative
+
       ! Grid
       real(ar),        intent(in   ) :: dx(3)
 
@@ -233,9 +237,13 @@ contains
                !   ugradu = ( div(u^MAC u^cc) - u^cc div(u^MAC) )
                ! ****************************************************
 
-               divumac = (u(i+1,j,k) - u(i,j,k)) * idx + &
-                         (v(i,j+1,k) - v(i,j,k)) * idy + &
-                         (w(i,j,k+1) - w(i,j,k)) * idz
+               if (conservative == 1) then
+                  divumac = zero
+               else
+                  divumac = (u(i+1,j,k) - u(i,j,k)) * idx + &
+                            (v(i,j+1,k) - v(i,j,k)) * idy + &
+                            (w(i,j,k+1) - w(i,j,k)) * idz
+               end if
 
                ugradu(i,j,k,1) = (u(i+1,j,k) * u_e - u(i,j,k) * u_w) * idx + &
                                  (v(i,j+1,k) * u_n - v(i,j,k) * u_s) * idy + &
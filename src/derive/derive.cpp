@@ -3,19 +3,19 @@
 
 #include <incflo.H>
 #include <derive_F.H>
+#include <diffusion_F.H>
 #include <projection_F.H>
 
 void incflo::UpdateDerivedQuantities()
 {
     BL_PROFILE("incflo::UpdateDerivedQuantities()");
+    INCFLO_TIMER("UpdateDerivedQuantities");
 
-    ComputeDivU(cur_time);
     ComputeStrainrate();
     ComputeViscosity();
-    ComputeVorticity();
 }
 
-void incflo::ComputeDivU(Real time)
+Vector<std::unique_ptr<MultiFab>> incflo::ComputeDivU(Real time)
 {
     int extrap_dir_bcs = 0;
     FillVelocityBC(time, extrap_dir_bcs);
@@ -49,510 +49,595 @@ void incflo::ComputeDivU(Real time)
                        {(LinOpBCType)bc_hi[0], (LinOpBCType)bc_hi[1], (LinOpBCType)bc_hi[2]});
 #endif
 
+    Vector<std::unique_ptr<MultiFab>> divu(finest_level + 1);
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        const BoxArray& nd_grids = amrex::convert(grids[lev], IntVect{1,1,1});
+        divu[lev] = scratch.acquire(nd_grids, dmap[lev], 1, 0, *ebfactory[lev]);
+    }
+
     matrix.compDivergence(GetVecOfPtrs(divu), GetVecOfPtrs(vel)); 
+
+    return divu;
 }
 
 void incflo::ComputeStrainrate()
 {
     BL_PROFILE("incflo::ComputeStrainrate");
 
-    // Declare components of velocity gradient
-    Real ux, uy, uz, vx, vy, vz, wx, wy, wz;
-
     for(int lev = 0; lev <= finest_level; lev++)
     {
-        Box domain(geom[lev].Domain());
-        Real idx = 1.0 / geom[lev].CellSize()[0];
-        Real idy = 1.0 / geom[lev].CellSize()[1];
-        Real idz = 1.0 / geom[lev].CellSize()[2];
-
         // State with ghost cells
-        MultiFab Sborder(grids[lev], dmap[lev], vel[lev]->nComp(), nghost, 
-                         MFInfo(), *ebfactory[lev]);
-        FillPatchVel(lev, cur_time, Sborder, 0, Sborder.nComp());
+        std::unique_ptr<MultiFab> Sborder_ptr = scratch.acquire(grids[lev], dmap[lev], vel[lev]->nComp(),
+                                                                nghost, *ebfactory[lev]);
+        MultiFab& Sborder = *Sborder_ptr;
+
+        if(FillPatchVelStart(lev, cur_time, Sborder, 0, Sborder.nComp()))
+        {
+            // Interior tiles while the ghost cells are exchanged
+            ComputeStrainrate(lev, Sborder, TilePass::interior);
+            FillPatchVelFinish(lev, cur_time, Sborder, 0, Sborder.nComp());
+            ComputeStrainrate(lev, Sborder, TilePass::boundary);
+        }
+        else
+        {
+            ComputeStrainrate(lev, Sborder, TilePass::all);
+        }
     
         // Copy each FAB back from Sborder into the vel array, complete with filled ghost cells
         MultiFab::Copy(*vel[lev], Sborder, 0, 0, vel[lev]->nComp(), vel[lev]->nGrow());
 
+        scratch.release(std::move(Sborder_ptr));
+    }
+}
+
+//
+// Strain rate magnitude on level lev from the filled velocity in Sborder, in the tiles of pass
+//
+void incflo::ComputeStrainrate(int lev, MultiFab& Sborder, TilePass pass)
+{
+    Real idx = 1.0 / geom[lev].CellSize()[0];
+    Real idy = 1.0 / geom[lev].CellSize()[1];
+    Real idz = 1.0 / geom[lev].CellSize()[2];
+
+    const EBTiles& tiles = GetEBTiles(lev);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for(MFIter mfi(Sborder, TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            // Tilebox
-            Box bx = mfi.tilebox();
+    for(MFIter mfi(Sborder, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        // The one-sided differences next to the EB reach two cells out
+        if(!DoTile(mfi, pass, 2)) continue;
 
-            // This is to check efficiently if this tile contains any eb stuff
-            const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>(Sborder[mfi]);
-            const EBCellFlagFab& flags = vel_fab.getEBCellFlagFab();
+        // Tilebox
+        Box bx = mfi.tilebox();
 
-            // Cell-centered velocity
-            const auto& ccvel_fab = vel[lev]->array(mfi);
+        const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>(Sborder[mfi]);
+        const EBCellFlagFab& flags = vel_fab.getEBCellFlagFab();
 
-            // Cell-centred strain-rate magnitude
-            const auto& sr_fab = strainrate[lev]->array(mfi);
+        // Cell-centered velocity
+        const auto& ccvel_fab = Sborder.array(mfi);
 
-            if (flags.getType(amrex::grow(bx, 0)) == FabType::covered)
-            {
-                (*strainrate[lev])[mfi].setVal(1.2345e200, bx);
-            }
-            else if(flags.getType(amrex::grow(bx, 1)) == FabType::regular)
+        // Cell-centred strain-rate magnitude
+        const auto& sr_fab = strainrate[lev]->array(mfi);
+
+        if (tiles.type(mfi, 0) == FabType::covered)
+        {
+            (*strainrate[lev])[mfi].setVal(1.2345e200, bx);
+        }
+        else if(tiles.type(mfi, 1) == FabType::regular)
+        {
+            // No cut cells in tile + 1-cell witdh halo -> use non-eb routine
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
             {
-                // No cut cells in tile + 1-cell witdh halo -> use non-eb routine
-                AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
-                {
-                    ux = 0.5 * (ccvel_fab(i+1,j,k,0) - ccvel_fab(i-1,j,k,0)) * idx;
-                    vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
-                    wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
+                // Components of the velocity gradient (local to each cell, so thread-safe)
+                Real ux, uy, uz, vx, vy, vz, wx, wy, wz;
 
-                    uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
-                    vy = 0.5 * (ccvel_fab(i,j+1,k,1) - ccvel_fab(i,j-1,k,1)) * idy;
-                    wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
+                ux = 0.5 * (ccvel_fab(i+1,j,k,0) - ccvel_fab(i-1,j,k,0)) * idx;
+                vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
+                wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
 
-                    uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
-                    vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
-                    wz = 0.5 * (ccvel_fab(i,j,k+1,2) - ccvel_fab(i,j,k-1,2)) * idz;
+                uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
+                vy = 0.5 * (ccvel_fab(i,j+1,k,1) - ccvel_fab(i,j-1,k,1)) * idy;
+                wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
 
-                    // Include the factor half here rather than in each of the above
-                    sr_fab(i,j,k) = sqrt(2.0 * pow(ux, 2) + 2.0 * pow(vy, 2) + 2.0 * pow(wz, 2) 
-                            + pow(uy + vx, 2) + pow(vz + wy, 2) + pow(wx + uz, 2));
-                });
-            }
-            else
+                uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
+                vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
+                wz = 0.5 * (ccvel_fab(i,j,k+1,2) - ccvel_fab(i,j,k-1,2)) * idz;
+
+                // Include the factor half here rather than in each of the above
+                sr_fab(i,j,k) = sqrt(2.0 * pow(ux, 2) + 2.0 * pow(vy, 2) + 2.0 * pow(wz, 2) 
+                        + pow(uy + vx, 2) + pow(vz + wy, 2) + pow(wx + uz, 2));
+            });
+        }
+        else
+        {
+            // Cut cells present -> use EB routine! 
+            const auto& flag_fab = flags.array();
+            Real c0 = -1.5;
+            Real c1 = 2.0;
+            Real c2 = -0.5;
+
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
             {
-                // Cut cells present -> use EB routine! 
-                const auto& flag_fab = flags.array();
-                Real c0 = -1.5;
-                Real c1 = 2.0;
-                Real c2 = -0.5;
+                // Components of the velocity gradient (local to each cell, so thread-safe)
+                Real ux, uy, uz, vx, vy, vz, wx, wy, wz;
 
-                AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+                if (flag_fab(i,j,k).isCovered())
                 {
-                    if (flag_fab(i,j,k).isCovered())
-                    {
-                        // Don't compute strainrate in cut cells
-                        sr_fab(i,j,k) = 1.2345e200;
-                    }
-                    else 
+                    // Don't compute strainrate in cut cells
+                    sr_fab(i,j,k) = 1.2345e200;
+                }
+                else 
+                {
+                    if (flag_fab(i,j,k).isSingleValued())
                     {
-                        if (flag_fab(i,j,k).isSingleValued())
+                        // Need to check if there are covered cells in neighbours --
+                        // -- if so, use one-sided difference computation (but still quadratic)
+                        if (flag_fab(i+1,j,k).isCovered())
+                        {
+                            // Covered cell to the right, go fish left
+                            ux = - (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i-1,j,k,0) 
+                                + c2 * ccvel_fab(i-2,j,k,0)) * idx;
+                            vx = - (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i-1,j,k,1) 
+                                + c2 * ccvel_fab(i-2,j,k,1)) * idx;
+                            wx = - (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i-1,j,k,2) 
+                                + c2 * ccvel_fab(i-2,j,k,2)) * idx;
+                        }
+                        else if (flag_fab(i-1,j,k).isCovered())
                         {
-                            // Need to check if there are covered cells in neighbours --
-                            // -- if so, use one-sided difference computation (but still quadratic)
-                            if (flag_fab(i+1,j,k).isCovered())
-                            {
-                                // Covered cell to the right, go fish left
-                                ux = - (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i-1,j,k,0) 
-                                    + c2 * ccvel_fab(i-2,j,k,0)) * idx;
-                                vx = - (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i-1,j,k,1) 
-                                    + c2 * ccvel_fab(i-2,j,k,1)) * idx;
-                                wx = - (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i-1,j,k,2) 
-                                    + c2 * ccvel_fab(i-2,j,k,2)) * idx;
-                            }
-                            else if (flag_fab(i-1,j,k).isCovered())
-                            {
-                                // Covered cell to the left, go fish right
-                                ux = (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i+1,j,k,0) 
-                                    + c2 * ccvel_fab(i+2,j,k,0)) * idx;
-                                vx = (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i+1,j,k,1) 
-                                    + c2 * ccvel_fab(i+2,j,k,1)) * idx;
-                                wx = (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i+1,j,k,2) 
-                                    + c2 * ccvel_fab(i+2,j,k,2)) * idx;
-                            }
-                            else
-                            {
-                               // No covered cells right or left, use standard stencil
-                                ux = 0.5 * (ccvel_fab(i+1,j,k,0) - ccvel_fab(i-1,j,k,0)) * idx;
-                                vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
-                                wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
-                            }
-                            // Do the same in y-direction 
-                            if (flag_fab(i,j+1,k).isCovered())
-                            {
-                                uy = - (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j-1,k,0) 
-                                    + c2 * ccvel_fab(i,j-2,k,0)) * idy;
-                                vy = - (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i,j-1,k,1) 
-                                    + c2 * ccvel_fab(i,j-2,k,1)) * idy;
-                                wy = - (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i,j-1,k,2) 
-                                    + c2 * ccvel_fab(i,j-2,k,2)) * idy;
-                            }
-                            else if (flag_fab(i,j-1,k).isCovered())
-                            {
-                                uy = (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j+1,k,0) 
-                                    + c2 * ccvel_fab(i,j+2,k,0)) * idy;
-                                vy = (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i,j+1,k,1) 
-                                    + c2 * ccvel_fab(i,j+2,k,1)) * idy;
-                                wy = (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i,j+1,k,2) 
-                                    + c2 * ccvel_fab(i,j+2,k,2)) * idy;
-                            }
-                            else
-                            {
-                                uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
-                                vy = 0.5 * (ccvel_fab(i,j+1,k,1) - ccvel_fab(i,j-1,k,1)) * idy;
-                                wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
-                            }
-
-                            // Do the same in z-direction 
-                            if (flag_fab(i,j,k+1).isCovered())
-                            {
-                                uz = - (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j,k-1,0) 
-                                    + c2 * ccvel_fab(i,j,k-2,0)) * idz;
-                                vz = - (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i,j,k-1,1) 
-                                    + c2 * ccvel_fab(i,j,k-2,1)) * idz;
-                                wz = - (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i,j,k-1,2) 
-                                    + c2 * ccvel_fab(i,j,k-2,2)) * idz;
-                            }
-                            else if (flag_fab(i,j,k-1).isCovered())
-                            {
-                                uz = (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j,k+1,0) 
-                                    + c2 * ccvel_fab(i,j,k+2,0)) * idz;
-                                vz = (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i,j,k+1,1) 
-                                    + c2 * ccvel_fab(i,j,k+2,1)) * idz;
-                                wz = (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i,j,k+1,2) 
-                                    + c2 * ccvel_fab(i,j,k+2,2)) * idz;
-                            }
-                            else
-                            {
-                                uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
-                                vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
-                                wz = 0.5 * (ccvel_fab(i,j,k+1,2) - ccvel_fab(i,j,k-1,2)) * idz;
-                            }
+                            // Covered cell to the left, go fish right
+                            ux = (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i+1,j,k,0) 
+                                + c2 * ccvel_fab(i+2,j,k,0)) * idx;
+                            vx = (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i+1,j,k,1) 
+                                + c2 * ccvel_fab(i+2,j,k,1)) * idx;
+                            wx = (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i+1,j,k,2) 
+                                + c2 * ccvel_fab(i+2,j,k,2)) * idx;
                         }
                         else
                         {
+                           // No covered cells right or left, use standard stencil
                             ux = 0.5 * (ccvel_fab(i+1,j,k,0) - ccvel_fab(i-1,j,k,0)) * idx;
                             vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
                             wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
-
+                        }
+                        // Do the same in y-direction 
+                        if (flag_fab(i,j+1,k).isCovered())
+                        {
+                            uy = - (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j-1,k,0) 
+                                + c2 * ccvel_fab(i,j-2,k,0)) * idy;
+                            vy = - (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i,j-1,k,1) 
+                                + c2 * ccvel_fab(i,j-2,k,1)) * idy;
+                            wy = - (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i,j-1,k,2) 
+                                + c2 * ccvel_fab(i,j-2,k,2)) * idy;
+                        }
+                        else if (flag_fab(i,j-1,k).isCovered())
+                        {
+                            uy = (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j+1,k,0) 
+                                + c2 * ccvel_fab(i,j+2,k,0)) * idy;
+                            vy = (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i,j+1,k,1) 
+                                + c2 * ccvel_fab(i,j+2,k,1)) * idy;
+                            wy = (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i,j+1,k,2) 
+                                + c2 * ccvel_fab(i,j+2,k,2)) * idy;
+                        }
+                        else
+                        {
                             uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
                             vy = 0.5 * (ccvel_fab(i,j+1,k,1) - ccvel_fab(i,j-1,k,1)) * idy;
                             wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
+                        }
 
+                        // Do the same in z-direction 
+                        if (flag_fab(i,j,k+1).isCovered())
+                        {
+                            uz = - (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j,k-1,0) 
+                                + c2 * ccvel_fab(i,j,k-2,0)) * idz;
+                            vz = - (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i,j,k-1,1) 
+                                + c2 * ccvel_fab(i,j,k-2,1)) * idz;
+                            wz = - (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i,j,k-1,2) 
+                                + c2 * ccvel_fab(i,j,k-2,2)) * idz;
+                        }
+                        else if (flag_fab(i,j,k-1).isCovered())
+                        {
+                            uz = (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j,k+1,0) 
+                                + c2 * ccvel_fab(i,j,k+2,0)) * idz;
+                            vz = (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i,j,k+1,1) 
+                                + c2 * ccvel_fab(i,j,k+2,1)) * idz;
+                            wz = (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i,j,k+1,2) 
+                                + c2 * ccvel_fab(i,j,k+2,2)) * idz;
+                        }
+                        else
+                        {
                             uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
                             vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
                             wz = 0.5 * (ccvel_fab(i,j,k+1,2) - ccvel_fab(i,j,k-1,2)) * idz;
                         }
-                        sr_fab(i,j,k) = sqrt(2.0 * pow(ux, 2) + 2.0 * pow(vy, 2) + 2.0 * pow(wz, 2)
-                                + pow(uy + vx, 2) + pow(vz + wy, 2) + pow(wx + uz, 2));
                     }
-                });
-            }
+                    else
+                    {
+                        ux = 0.5 * (ccvel_fab(i+1,j,k,0) - ccvel_fab(i-1,j,k,0)) * idx;
+                        vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
+                        wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
+
+                        uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
+                        vy = 0.5 * (ccvel_fab(i,j+1,k,1) - ccvel_fab(i,j-1,k,1)) * idy;
+                        wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
+
+                        uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
+                        vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
+                        wz = 0.5 * (ccvel_fab(i,j,k+1,2) - ccvel_fab(i,j,k-1,2)) * idz;
+                    }
+                    sr_fab(i,j,k) = sqrt(2.0 * pow(ux, 2) + 2.0 * pow(vy, 2) + 2.0 * pow(wz, 2)
+                            + pow(uy + vx, 2) + pow(vz + wy, 2) + pow(wx + uz, 2));
+                }
+            });
         }
     }
 }
 
-void incflo::ComputeVorticity()
+Vector<std::unique_ptr<MultiFab>> incflo::ComputeVorticity()
 {
 	BL_PROFILE("incflo::ComputeVorticity");
 
-    // Declare components of velocity gradient
-    Real uy, uz, vx, vz, wx, wy;
+    Vector<std::unique_ptr<MultiFab>> vort(finest_level + 1);
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
-        Box domain(geom[lev].Domain());
-        Real idx = 1.0 / geom[lev].CellSize()[0];
-        Real idy = 1.0 / geom[lev].CellSize()[1];
-        Real idz = 1.0 / geom[lev].CellSize()[2];
+        // The ghost cells are only filled by the users that need them
+        vort[lev] = scratch.acquire(grids[lev], dmap[lev], 1, ng_vort, *ebfactory[lev]);
+        vort[lev]->setBndry(0.0);
 
         // State with ghost cells
-        MultiFab Sborder(grids[lev], dmap[lev], vel[lev]->nComp(), nghost, 
-                         MFInfo(), *ebfactory[lev]);
-        FillPatchVel(lev, cur_time, Sborder, 0, Sborder.nComp());
+        std::unique_ptr<MultiFab> Sborder_ptr = scratch.acquire(grids[lev], dmap[lev], vel[lev]->nComp(),
+                                                                nghost, *ebfactory[lev]);
+        MultiFab& Sborder = *Sborder_ptr;
+
+        if(FillPatchVelStart(lev, cur_time, Sborder, 0, Sborder.nComp()))
+        {
+            // Interior tiles while the ghost cells are exchanged
+            ComputeVorticity(lev, Sborder, *vort[lev], TilePass::interior);
+            FillPatchVelFinish(lev, cur_time, Sborder, 0, Sborder.nComp());
+            ComputeVorticity(lev, Sborder, *vort[lev], TilePass::boundary);
+        }
+        else
+        {
+            ComputeVorticity(lev, Sborder, *vort[lev], TilePass::all);
+        }
     
         // Copy each FAB back from Sborder into the vel array, complete with filled ghost cells
         MultiFab::Copy (*vel[lev], Sborder, 0, 0, vel[lev]->nComp(), vel[lev]->nGrow());
 
+        scratch.release(std::move(Sborder_ptr));
+    }
+
+    return vort;
+}
+
+//
+// Vorticity magnitude on level lev from the filled velocity in Sborder, in the tiles of pass
+//
+void incflo::ComputeVorticity(int lev, MultiFab& Sborder, MultiFab& vort, TilePass pass)
+{
+    Real idx = 1.0 / geom[lev].CellSize()[0];
+    Real idy = 1.0 / geom[lev].CellSize()[1];
+    Real idz = 1.0 / geom[lev].CellSize()[2];
+
+    const EBTiles& tiles = GetEBTiles(lev);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for(MFIter mfi(Sborder, TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            // Tilebox
-            Box bx = mfi.tilebox();
+    for(MFIter mfi(Sborder, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        // The one-sided differences next to the EB reach two cells out
+        if(!DoTile(mfi, pass, 2)) continue;
 
-            // This is to check efficiently if this tile contains any eb stuff
-            const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>(Sborder[mfi]);
-            const EBCellFlagFab& flags = vel_fab.getEBCellFlagFab();
+        // Tilebox
+        Box bx = mfi.tilebox();
 
-            // Cell-centered velocity
-            const auto& ccvel_fab = vel[lev]->array(mfi);
+        const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>(Sborder[mfi]);
+        const EBCellFlagFab& flags = vel_fab.getEBCellFlagFab();
 
-            // Cell-centred strain-rate magnitude
-            const auto& vort_fab = vort[lev]->array(mfi);
+        // Cell-centered velocity
+        const auto& ccvel_fab = Sborder.array(mfi);
 
-            if (flags.getType(amrex::grow(bx, 0)) == FabType::covered)
-            {
-                (*vort[lev])[mfi].setVal(1.2345e200, bx);
-            }
-            else if(flags.getType(amrex::grow(bx, 1)) == FabType::regular)
+        // Cell-centred strain-rate magnitude
+        const auto& vort_fab = vort.array(mfi);
+
+        if (tiles.type(mfi, 0) == FabType::covered)
+        {
+            vort[mfi].setVal(1.2345e200, bx);
+        }
+        else if(tiles.type(mfi, 1) == FabType::regular)
+        {
+            // No cut cells in tile + 1-cell witdh halo -> use non-eb routine
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
             {
-                // No cut cells in tile + 1-cell witdh halo -> use non-eb routine
-                AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
-                {
-                    vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
-                    wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
+                // Components of the velocity gradient (local to each cell, so thread-safe)
+                Real uy, uz, vx, vz, wx, wy;
 
-                    uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
-                    wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
+                vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
+                wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
 
-                    uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
-                    vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
+                uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
+                wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
 
-                    vort_fab(i,j,k) = sqrt( pow(wy - vz, 2) + pow(uz - wx, 2) + pow(vx - uy, 2));
-                });
-            }
-            else
+                uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
+                vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
+
+                vort_fab(i,j,k) = sqrt( pow(wy - vz, 2) + pow(uz - wx, 2) + pow(vx - uy, 2));
+            });
+        }
+        else
+        {
+            // Cut cells present -> use EB routine! 
+            const auto& flag_fab = flags.array();
+            Real c0 = -1.5;
+            Real c1 = 2.0;
+            Real c2 = -0.5;
+
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
             {
-                // Cut cells present -> use EB routine! 
-                const auto& flag_fab = flags.array();
-                Real c0 = -1.5;
-                Real c1 = 2.0;
-                Real c2 = -0.5;
+                // Components of the velocity gradient (local to each cell, so thread-safe)
+                Real uy, uz, vx, vz, wx, wy;
 
-                AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+                if (flag_fab(i,j,k).isCovered())
                 {
-                    if (flag_fab(i,j,k).isCovered())
-                    {
-                        // Don't compute strainrate in cut cells
-                        vort_fab(i,j,k) = 1.2345e200;
-                    }
-                    else 
+                    // Don't compute strainrate in cut cells
+                    vort_fab(i,j,k) = 1.2345e200;
+                }
+                else 
+                {
+                    if (flag_fab(i,j,k).isSingleValued())
                     {
-                        if (flag_fab(i,j,k).isSingleValued())
+                        // Need to check if there are covered cells in neighbours --
+                        // -- if so, use one-sided difference computation (but still quadratic)
+                        if (flag_fab(i+1,j,k).isCovered())
+                        {
+                            // Covered cell to the right, go fish left
+                            vx = - (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i-1,j,k,1) 
+                                + c2 * ccvel_fab(i-2,j,k,1)) * idx;
+                            wx = - (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i-1,j,k,2) 
+                                + c2 * ccvel_fab(i-2,j,k,2)) * idx;
+                        }
+                        else if (flag_fab(i-1,j,k).isCovered())
                         {
-                            // Need to check if there are covered cells in neighbours --
-                            // -- if so, use one-sided difference computation (but still quadratic)
-                            if (flag_fab(i+1,j,k).isCovered())
-                            {
-                                // Covered cell to the right, go fish left
-                                vx = - (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i-1,j,k,1) 
-                                    + c2 * ccvel_fab(i-2,j,k,1)) * idx;
-                                wx = - (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i-1,j,k,2) 
-                                    + c2 * ccvel_fab(i-2,j,k,2)) * idx;
-                            }
-                            else if (flag_fab(i-1,j,k).isCovered())
-                            {
-                                // Covered cell to the left, go fish right
-                                vx = (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i+1,j,k,1) 
-                                    + c2 * ccvel_fab(i+2,j,k,1)) * idx;
-                                wx = (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i+1,j,k,2) 
-                                    + c2 * ccvel_fab(i+2,j,k,2)) * idx;
-                            }
-                            else
-                            {
-                                // No covered cells right or left, use standard stencil
-                                vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
-                                wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
-                            }
-                            // Do the same in y-direction 
-                            if (flag_fab(i,j+1,k).isCovered())
-                            {
-                                uy = - (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j-1,k,0) 
-                                    + c2 * ccvel_fab(i,j-2,k,0)) * idy;
-                                wy = - (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i,j-1,k,2) 
-                                    + c2 * ccvel_fab(i,j-2,k,2)) * idy;
-                            }
-                            else if (flag_fab(i,j-1,k).isCovered())
-                            {
-                                uy = (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j+1,k,0) 
-                                    + c2 * ccvel_fab(i,j+2,k,0)) * idy;
-                                wy = (c0 * ccvel_fab(i,j,k,2) 
-                                    + c1 * ccvel_fab(i,j+1,k,2) 
-                                    + c2 * ccvel_fab(i,j+2,k,2)) * idy;
-                            }
-                            else
-                            {
-                                uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
-                                wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
-                            }
-
-                            // Do the same in z-direction 
-                            if (flag_fab(i,j,k+1).isCovered())
-                            {
-                                uz = - (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j,k-1,0) 
-                                    + c2 * ccvel_fab(i,j,k-2,0)) * idz;
-                                vz = - (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i,j,k-1,1) 
-                                    + c2 * ccvel_fab(i,j,k-2,1)) * idz;
-                            }
-                            else if (flag_fab(i,j,k-1).isCovered())
-                            {
-                                uz = (c0 * ccvel_fab(i,j,k,0) 
-                                    + c1 * ccvel_fab(i,j,k+1,0) 
-                                    + c2 * ccvel_fab(i,j,k+2,0)) * idz;
-                                vz = (c0 * ccvel_fab(i,j,k,1) 
-                                    + c1 * ccvel_fab(i,j,k+1,1) 
-                                    + c2 * ccvel_fab(i,j,k+2,1)) * idz;
-                            }
-                            else
-                            {
-                                uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
-                                vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
-                            }
+                            // Covered cell to the left, go fish right
+                            vx = (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i+1,j,k,1) 
+                                + c2 * ccvel_fab(i+2,j,k,1)) * idx;
+                            wx = (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i+1,j,k,2) 
+                                + c2 * ccvel_fab(i+2,j,k,2)) * idx;
                         }
                         else
                         {
+                            // No covered cells right or left, use standard stencil
                             vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
                             wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
-
+                        }
+                        // Do the same in y-direction 
+                        if (flag_fab(i,j+1,k).isCovered())
+                        {
+                            uy = - (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j-1,k,0) 
+                                + c2 * ccvel_fab(i,j-2,k,0)) * idy;
+                            wy = - (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i,j-1,k,2) 
+                                + c2 * ccvel_fab(i,j-2,k,2)) * idy;
+                        }
+                        else if (flag_fab(i,j-1,k).isCovered())
+                        {
+                            uy = (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j+1,k,0) 
+                                + c2 * ccvel_fab(i,j+2,k,0)) * idy;
+                            wy = (c0 * ccvel_fab(i,j,k,2) 
+                                + c1 * ccvel_fab(i,j+1,k,2) 
+                                + c2 * ccvel_fab(i,j+2,k,2)) * idy;
+                        }
+                        else
+                        {
                             uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
                             wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
+                        }
 
+                        // Do the same in z-direction 
+                        if (flag_fab(i,j,k+1).isCovered())
+                        {
+                            uz = - (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j,k-1,0) 
+                                + c2 * ccvel_fab(i,j,k-2,0)) * idz;
+                            vz = - (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i,j,k-1,1) 
+                                + c2 * ccvel_fab(i,j,k-2,1)) * idz;
+                        }
+                        else if (flag_fab(i,j,k-1).isCovered())
+                        {
+                            uz = (c0 * ccvel_fab(i,j,k,0) 
+                                + c1 * ccvel_fab(i,j,k+1,0) 
+                                + c2 * ccvel_fab(i,j,k+2,0)) * idz;
+                            vz = (c0 * ccvel_fab(i,j,k,1) 
+                                + c1 * ccvel_fab(i,j,k+1,1) 
+                                + c2 * ccvel_fab(i,j,k+2,1)) * idz;
+                        }
+                        else
+                        {
                             uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
                             vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
                         }
-                        vort_fab(i,j,k) = sqrt(pow(wy-vz,2) + pow(uz-wx,2) + pow(vx-uy,2));
                     }
-                });
-            } // Cut cells
-        } // MFIter
-    } // Loop over levels
+                    else
+                    {
+                        vx = 0.5 * (ccvel_fab(i+1,j,k,1) - ccvel_fab(i-1,j,k,1)) * idx;
+                        wx = 0.5 * (ccvel_fab(i+1,j,k,2) - ccvel_fab(i-1,j,k,2)) * idx;
+
+                        uy = 0.5 * (ccvel_fab(i,j+1,k,0) - ccvel_fab(i,j-1,k,0)) * idy;
+                        wy = 0.5 * (ccvel_fab(i,j+1,k,2) - ccvel_fab(i,j-1,k,2)) * idy;
+
+                        uz = 0.5 * (ccvel_fab(i,j,k+1,0) - ccvel_fab(i,j,k-1,0)) * idz;
+                        vz = 0.5 * (ccvel_fab(i,j,k+1,1) - ccvel_fab(i,j,k-1,1)) * idz;
+                    }
+                    vort_fab(i,j,k) = sqrt(pow(wy-vz,2) + pow(uz-wx,2) + pow(vx-uy,2));
+                }
+            });
+        } // Cut cells
+    } // MFIter
 }
 
-void incflo::ComputeDrag()
+//
+// Pressure and viscous force and torque on the bodies of force_monitor, integrated over the cut
+// cells of all levels (those not covered by a finer level) in one sweep of the cut-cell lists.
+// On return, values holds ForceMonitor::nvalues values per body: the pressure force, viscous
+// force, pressure torque and viscous torque (three components each).
+//
+void incflo::ComputeForces(Vector<Real>& values)
 {
-	BL_PROFILE("incflo::ComputeDrag");
+	BL_PROFILE("incflo::ComputeForces");
 
-    // Coefficients for one-sided difference estimation
-    Real c0 = -1.5;
-    Real c1 = 2.0; 
-    Real c2 = -0.5;
+    const int nvalues = ForceMonitor::nvalues;
+    values.assign(nvalues * force_monitor->numBodies(), 0.0);
 
+    // Cut-cell lists and the grids of the next finer level, set up before the threads start
+    Vector<const EBTiles*> tiles(finest_level + 1);
+    Vector<BoxArray> fine_ba(finest_level + 1);
     for(int lev = 0; lev <= finest_level; lev++)
     {
-        Box domain(geom[lev].Domain());
-        Real dx = geom[lev].CellSize()[0];
-        
-        // Get EB geometric info
-        const amrex::MultiCutFab* bndryarea;
-        const amrex::MultiCutFab* bndrynorm;
-        bndryarea = &(ebfactory[lev]->getBndryArea());
-        bndrynorm = &(ebfactory[lev]->getBndryNormal());
+        tiles[lev] = &GetEBTiles(lev);
+
+        // Cut cells under finer grids are done on the finer level
+        if(lev < finest_level) fine_ba[lev] = amrex::coarsen(grids[lev + 1], refRatio(lev));
+    }
 
 #ifdef _OPENMP
-#pragma omp parallel for reduction(+:drag) if (Gpu::notInLaunchRegion())
+#pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for(MFIter mfi(*vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        // Sums of this thread over all levels
+        Vector<Real> sums(values.size(), 0.0);
+
+        for(int lev = 0; lev <= finest_level; lev++)
         {
-            // Tilebox
-            Box bx = mfi.tilebox();
+            const Real* dx = geom[lev].CellSize();
+            const Real* plo = geom[lev].ProbLo();
+
+            // The grid spacing is uniform (as in the EB operators)
+            const Real da = dx[0] * dx[0];
 
-            // This is to check efficiently if this tile contains any eb stuff
-            const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>((*vel[lev])[mfi]);
-            const EBCellFlagFab& flags = vel_fab.getEBCellFlagFab();
+            // Get EB geometric info
+            Array<const MultiCutFab*, AMREX_SPACEDIM> areafrac = ebfactory[lev]->getAreaFrac();
+            const MultiFab*    volfrac   = &(ebfactory[lev]->getVolFrac());
+            const MultiCutFab* bndrycent = &(ebfactory[lev]->getBndryCent());
+            const MultiCutFab* bndryarea = &(ebfactory[lev]->getBndryArea());
+            const MultiCutFab* bndrynorm = &(ebfactory[lev]->getBndryNormal());
 
-            if (flags.getType(bx) == FabType::singlevalued)
+            for(MFIter mfi(*vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
             {
-                const auto& drag_arr = drag[lev]->array(mfi);
-                const auto& vel_arr = vel[lev]->array(mfi);
-                const auto& eta_arr = eta[lev]->array(mfi);
+                const Vector<IntVect>& cut = tiles[lev]->cutCells(mfi);
+                if(cut.empty()) continue;
+
+                const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>((*vel[lev])[mfi]);
+                const EBCellFlagFab& flags = vel_fab.getEBCellFlagFab();
+
                 const auto& p_arr = p[lev]->array(mfi);
-                const auto& bndryarea_arr = bndryarea->array(mfi);
-                const auto& bndrynorm_arr = bndrynorm->array(mfi);
-                const auto& flag_arr = flags.array();
+                const auto& p0_arr = p0[lev]->array(mfi);
+                const auto& bcent_arr = bndrycent->array(mfi);
+                const auto& barea_arr = bndryarea->array(mfi);
+                const auto& bnorm_arr = bndrynorm->array(mfi);
 
-                for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
-                for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
-                for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+                for(const IntVect& iv : cut)
                 {
-                    if(flag_arr(i,j,k).isSingleValued())
-                    {
-                        Real area = bndryarea_arr(i,j,k);
-                        Real nx = bndrynorm_arr(i,j,k,0);
-                        Real ny = bndrynorm_arr(i,j,k,1);
-                        Real nz = bndrynorm_arr(i,j,k,2);
+                    if(lev < finest_level && fine_ba[lev].contains(iv)) continue;
 
-                        Real uz, vz, wx, wy, wz;
-
-                        if(flag_arr(i,j,k+1).isCovered())
-                        {
-                            uz = - (c0 * vel_arr(i,j,k,0) + c1 * vel_arr(i,j,k-1,0) + c2 * vel_arr(i,j,k-2,0)) / dx;
-                            vz = - (c0 * vel_arr(i,j,k,1) + c1 * vel_arr(i,j,k-1,1) + c2 * vel_arr(i,j,k-2,1)) / dx;
-                            wz = - (c0 * vel_arr(i,j,k,2) + c1 * vel_arr(i,j,k-1,2) + c2 * vel_arr(i,j,k-2,2)) / dx;
-                        }
-                        else if(flag_arr(i,j,k-1).isCovered())
-                        {
-                            uz = (c0 * vel_arr(i,j,k,0) + c1 * vel_arr(i,j,k+1,0) + c2 * vel_arr(i,j,k+2,0)) / dx;
-                            vz = (c0 * vel_arr(i,j,k,1) + c1 * vel_arr(i,j,k+1,1) + c2 * vel_arr(i,j,k+2,1)) / dx;
-                            wz = (c0 * vel_arr(i,j,k,2) + c1 * vel_arr(i,j,k+1,2) + c2 * vel_arr(i,j,k+2,2)) / dx;
-                        }
-                        else
-                        {
-                            uz = 0.5 * (vel_arr(i,j,k+1,0) - vel_arr(i,j,k-1,0)) / dx;
-                            vz = 0.5 * (vel_arr(i,j,k+1,1) - vel_arr(i,j,k-1,1)) / dx;
-                            wz = 0.5 * (vel_arr(i,j,k+1,2) - vel_arr(i,j,k-1,2)) / dx;
-                        }
+                    const int i = iv[0];
+                    const int j = iv[1];
+                    const int k = iv[2];
 
-                        if(flag_arr(i,j+1,k).isCovered())
-                        {
-                            wy = - (c0 * vel_arr(i,j,k,2) + c1 * vel_arr(i,j-1,k,2) + c2 * vel_arr(i,j-2,k,2)) / dx;
-                        }
-                        else if(flag_arr(i,j-1,k).isCovered())
-                        {
-                            wy = (c0 * vel_arr(i,j,k,2) + c1 * vel_arr(i,j+1,k,2) + c2 * vel_arr(i,j+2,k,2)) / dx;
-                        }
-                        else
-                        {
-                            wy = 0.5 * (vel_arr(i,j+1,k,2) - vel_arr(i,j-1,k,2)) / dx;
-                        }
+                    // Centroid of the wall in the cell
+                    RealArray x;
+                    for(int d = 0; d < 3; d++)
+                    {
+                        x[d] = plo[d] + (iv[d] + 0.5 + bcent_arr(i,j,k,d)) * dx[d];
+                    }
 
-                        if(flag_arr(i+1,j,k).isCovered())
-                        {
-                            wx = - (c0 * vel_arr(i,j,k,2) + c1 * vel_arr(i-1,j,k,2) + c2 * vel_arr(i-2,j,k,2)) / dx;
-                        }
-                        else if(flag_arr(i-1,j,k).isCovered())
-                        {
-                            wx = (c0 * vel_arr(i,j,k,2) + c1 * vel_arr(i+1,j,k,2) + c2 * vel_arr(i+2,j,k,2)) / dx;
-                        }
-                        else
-                        {
-                            wx = 0.5 * (vel_arr(i+1,j,k,2) - vel_arr(i-1,j,k,2)) / dx;
-                        }
+                    const int b = force_monitor->body(x);
+                    if(b < 0) continue;
 
-                        Real p_contrib = p_arr(i,j,k) * nz;
-                        Real tau_contrib = - eta_arr(i,j,k) * ( (uz + wx) * nx + (vz + wy) * ny + (wz + wz) * nz );
+                    // Pressure at the wall centroid, interpolated from the nodes of the cell
+                    Real pw = 0.0;
+                    for(int kk = 0; kk < 2; kk++)
+                    for(int jj = 0; jj < 2; jj++)
+                    for(int ii = 0; ii < 2; ii++)
+                    {
+                        Real wt = (ii ? 0.5 + bcent_arr(i,j,k,0) : 0.5 - bcent_arr(i,j,k,0))
+                                * (jj ? 0.5 + bcent_arr(i,j,k,1) : 0.5 - bcent_arr(i,j,k,1))
+                                * (kk ? 0.5 + bcent_arr(i,j,k,2) : 0.5 - bcent_arr(i,j,k,2));
+                        pw += wt * (p_arr(i+ii,j+jj,k+kk) + p0_arr(i+ii,j+jj,k+kk));
+                    }
 
-                        // TODO: Get values on EB centroid, 
-                        //       not the default CC and nodal values
-                        drag_arr(i,j,k) = (p_contrib + tau_contrib) * area * dx * dx;
+                    // Viscous force, with the wall gradient of the viscous operator
+                    Real fv[3];
+                    compute_eb_wall_traction(fv, &i, &j, &k, dx,
+                                             BL_TO_FORTRAN_ANYD(vel_fab),
+                                             BL_TO_FORTRAN_ANYD((*bndrycent)[mfi]),
+                                             BL_TO_FORTRAN_ANYD(flags),
+                                             BL_TO_FORTRAN_ANYD((*areafrac[0])[mfi]),
+                                             BL_TO_FORTRAN_ANYD((*areafrac[1])[mfi]),
+                                             BL_TO_FORTRAN_ANYD((*areafrac[2])[mfi]),
+                                             BL_TO_FORTRAN_ANYD((*volfrac)[mfi]),
+                                             &cyl_speed);
+
+                    // The boundary normal points out of the fluid, into the body
+                    Real fp[3];
+                    for(int n = 0; n < 3; n++)
+                    {
+                        fp[n] = pw * bnorm_arr(i,j,k,n) * barea_arr(i,j,k) * da;
+                        fv[n] *= da;
                     }
-                    else
+
+                    const RealArray& c = force_monitor->center(b);
+                    const Real r[3] = {x[0] - c[0], x[1] - c[1], x[2] - c[2]};
+
+                    Real* s = &sums[nvalues * b];
+                    for(int n = 0; n < 3; n++)
                     {
-                        drag_arr(i,j,k) = 0.0;
+                        const int n1 = (n + 1) % 3;
+                        const int n2 = (n + 2) % 3;
+
+                        s[n    ] += fp[n];
+                        s[n + 3] += fv[n];
+                        s[n + 6] += r[n1] * fp[n2] - r[n2] * fp[n1];
+                        s[n + 9] += r[n1] * fv[n2] - r[n2] * fv[n1];
                     }
                 }
             }
-            else
-            {
-                (*drag[lev])[mfi].setVal(0.0, bx);
-            }
         }
+
+#ifdef _OPENMP
+#pragma omp critical (incflo_compute_forces)
+#endif
+        for(int n = 0; n < values.size(); n++) values[n] += sums[n];
     }
+
+    ParallelDescriptor::ReduceRealSum(values.dataPtr(), values.size());
 }
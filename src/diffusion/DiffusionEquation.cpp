@@ -5,6 +5,7 @@
 #include <AMReX_Vector.H>
 
 #include <DiffusionEquation.H>
+#include <PhaseTimer.H>
 #include <diffusion_F.H>
 #include <constants.H>
 
@@ -166,6 +167,12 @@ void DiffusionEquation::updateInternals(AmrCore* amrcore_in,
     amrex::Abort();
 }
 
+void DiffusionEquation::setConstantCoefficients(bool constant)
+{
+    constant_coeffs = constant;
+    coeffs_set = false;
+}
+
 //
 // Solve the matrix equation
 //
@@ -175,6 +182,7 @@ void DiffusionEquation::solve(Vector<std::unique_ptr<MultiFab>>& vel,
                               Real dt)
 {
 	BL_PROFILE("DiffusionEquation::solve");
+	INCFLO_TIMER("DiffusionSolve");
 
     // Update the coefficients of the matrix going into the solve based on the current state of the
     // simulation. Recall that the relevant matrix is
@@ -187,11 +195,18 @@ void DiffusionEquation::solve(Vector<std::unique_ptr<MultiFab>>& vel,
     //      beta: dt
     //      a: ro
     //      b: eta
+    //
+    // With constant coefficients, a, b and the EB coefficients are only set in the first solve
+    const bool reuse = constant_coeffs && coeffs_set;
 
     // Set alpha and beta
-    matrix.setScalars(1.0, dt);
+    if(!reuse || dt != coeffs_dt)
+    {
+        matrix.setScalars(1.0, dt);
+        coeffs_dt = dt;
+    }
 
-    for(int lev = 0; lev <= amrcore->finestLevel(); lev++)
+    for(int lev = 0; lev <= amrcore->finestLevel() && !reuse; lev++)
     {
         // Compute the spatially varying b coefficients (on faces) to equal the apparent viscosity
         average_cellcenter_to_face(GetArrOfPtrs(b[lev]), *eta[lev], amrcore->Geom(lev));
@@ -204,6 +219,11 @@ void DiffusionEquation::solve(Vector<std::unique_ptr<MultiFab>>& vel,
         matrix.setACoeffs(lev, (*ro[lev]));
         matrix.setBCoeffs(lev, GetArrOfConstPtrs(b[lev])); 
     }
+    coeffs_set = true;
+
+    // The homogeneous EB Dirichlet condition is the same for all components (unless the other
+    // components of a rotating cylinder set their own in between)
+    bool eb_homog_set = reuse && cyl_speed <= 0.0;
 
     if(verbose > 0)
     {
@@ -239,11 +259,12 @@ void DiffusionEquation::solve(Vector<std::unique_ptr<MultiFab>>& vel,
             {
                 matrix.setEBDirichlet(lev, *veb[lev], *eta[lev]);
             }
-            else
+            else if(!eb_homog_set)
             {
                 matrix.setEBHomogDirichlet(lev, *eta[lev]);
             }
         }
+        eb_homog_set = (cyl_speed <= 0.0);
 
         MLMG solver(matrix);
         setSolverSettings(solver);
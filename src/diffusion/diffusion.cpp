@@ -17,6 +17,7 @@ void incflo::ComputeDivTau(int lev,
                            Vector<std::unique_ptr<MultiFab>>& vel_in)
 {
     BL_PROFILE("incflo::ComputeDivTau");
+    INCFLO_TIMER("ComputeDivTau");
     Box domain(geom[lev].Domain());
 
     EB_set_covered(*vel[lev], covered_val);
@@ -32,6 +33,8 @@ void incflo::ComputeDivTau(int lev,
     volfrac   = &(ebfactory[lev] -> getVolFrac());
     bndrycent = &(ebfactory[lev] -> getBndryCent());
 
+    const EBTiles& tiles = GetEBTiles(lev);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -40,19 +43,19 @@ void incflo::ComputeDivTau(int lev,
         // Tilebox
         Box bx = mfi.tilebox();
 
-        // this is to check efficiently if this tile contains any eb stuff
         const EBFArrayBox&  vel_fab = static_cast<EBFArrayBox const&>((*vel_in[lev])[mfi]);
         const EBCellFlagFab&  flags = vel_fab.getEBCellFlagFab();
 
-        if (flags.getType(bx) == FabType::covered)
+        if (tiles.type(mfi, 0) == FabType::covered)
         {
             divtau_in[mfi].setVal(1.2345e200, bx, 0, AMREX_SPACEDIM);
         }
         else
         {
-            if (flags.getType(amrex::grow(bx,nghost)) == FabType::regular)
+            // Cells whose stencil only sees regular cells take the regular kernel
+            for (const Box& rbx : tiles.regularParts(mfi))
             {
-                compute_divtau(BL_TO_FORTRAN_BOX(bx),
+                compute_divtau(BL_TO_FORTRAN_BOX(rbx),
                                BL_TO_FORTRAN_ANYD(divtau_in[mfi]),
                                BL_TO_FORTRAN_ANYD((*vel_in[lev])[mfi]),
                                (*eta[lev])[mfi].dataPtr(),
@@ -63,9 +66,10 @@ void incflo::ComputeDivTau(int lev,
                                bc_klo[lev]->dataPtr(), bc_khi[lev]->dataPtr(),
                                geom[lev].CellSize(), &nghost);
             }
-            else
+
+            for (const Box& ebx : tiles.ebParts(mfi))
             {
-                compute_divtau_eb(BL_TO_FORTRAN_BOX(bx),
+                compute_divtau_eb(BL_TO_FORTRAN_BOX(ebx),
                                   BL_TO_FORTRAN_ANYD(divtau_in[mfi]),
                                   BL_TO_FORTRAN_ANYD((*vel_in[lev])[mfi]),
                                   (*eta[lev])[mfi].dataPtr(),
@@ -88,3 +92,111 @@ void incflo::ComputeDivTau(int lev,
         }
    }
 }
+
+//
+// Fully implicit viscous term (incflo.implicit_viscosity = 1). On entry vel holds the right hand
+// side without viscous term, u^rhs. Solve
+//
+//      ( 1 - dt / rho * div ( eta grad ) ) u* - dt / rho * div ( eta (grad u*)^T ) = u^rhs
+//
+// by iterating on the off-diagonal part: every iteration solves the diffusion equation with
+//
+//      rhs = u^rhs + dt * divtau
+//
+// where divtau = div ( eta (grad u)^T ) / rho of the latest u*. On entry divtau holds this term
+// for the velocity the step starts from. The iterations stop when max |u*_(m+1) - u*_m| is
+// below implicit_viscosity_tol times max |u*|, or after implicit_viscosity_max_iter solves.
+//
+// This is a fixed-point iteration, whose contraction factor tends to 1 as dt grows. Returns
+// false if it does not converge, with u* the last iterate: Advance() then redoes the step with
+// the dt limited by the viscosity.
+//
+bool incflo::SolveViscousImplicit(Vector<std::unique_ptr<MultiFab>>& divtau_in, Real time)
+{
+    BL_PROFILE("incflo::SolveViscousImplicit");
+    INCFLO_TIMER("SolveViscousImplicit");
+
+    // Density of the momentum updates (divided by the local time step ratio for local time steps)
+    const Vector<std::unique_ptr<MultiFab>>& ro_step = StepDensity();
+
+    // Right hand side without the viscous term, and the previous iterate
+    Vector<std::unique_ptr<MultiFab>> vel_rhs(finest_level + 1);
+    Vector<std::unique_ptr<MultiFab>> vel_prev(finest_level + 1);
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        vel_rhs[lev] = scratch.acquire(grids[lev], dmap[lev], AMREX_SPACEDIM, 0, *ebfactory[lev]);
+        vel_prev[lev] = scratch.acquire(grids[lev], dmap[lev], AMREX_SPACEDIM, 0, *ebfactory[lev]);
+        MultiFab::Copy(*vel_rhs[lev], *vel[lev], 0, 0, AMREX_SPACEDIM, 0);
+    }
+
+    bool converged = false;
+    for(int iter = 1; ; iter++)
+    {
+        for(int lev = 0; lev <= finest_level; lev++)
+        {
+            MultiFab::LinComb(*vel[lev], 1.0, *vel_rhs[lev], 0, dt, *divtau_in[lev], 0, 0, AMREX_SPACEDIM, 0);
+        }
+        FillVelocityBC(time, 0);
+
+        diffusion_equation->solve(vel, ro_step, eta, dt);
+        FillVelocityBC(time, 0);
+
+        // Relative change of u* since the previous iteration
+        Real change = 0.0;
+        if(iter > 1)
+        {
+            Real velmax = 0.0;
+            for(int lev = 0; lev <= finest_level; lev++)
+            {
+                MultiFab::LinComb(*vel_prev[lev], 1.0, *vel[lev], 0, -1.0, *vel_prev[lev], 0, 0, AMREX_SPACEDIM, 0);
+                for(int n = 0; n < AMREX_SPACEDIM; n++)
+                {
+                    change = amrex::max(change, Norm(vel_prev, lev, n, 0));
+                    velmax = amrex::max(velmax, Norm(vel, lev, n, 0));
+                }
+            }
+            change = velmax > 1.0e-15 ? change / velmax : 0.0;
+
+            if(incflo_verbose > 1)
+            {
+                amrex::Print() << "Implicit viscous solve: iteration " << iter
+                               << ", relative change = " << change << std::endl;
+            }
+
+            if(change < implicit_viscosity_tol)
+            {
+                if(incflo_verbose > 0)
+                {
+                    amrex::Print() << "Implicit viscous solve converged in " << iter
+                                   << " iterations" << std::endl;
+                }
+                converged = true;
+                break;
+            }
+        }
+
+        if(iter == implicit_viscosity_max_iter)
+        {
+            amrex::Print() << "Warning: implicit viscous solve not converged in " << iter
+                           << " iterations, relative change = " << change << std::endl;
+            break;
+        }
+
+        // Off-diagonal term of the new iterate
+        for(int lev = 0; lev <= finest_level; lev++)
+        {
+            MultiFab::Copy(*vel_prev[lev], *vel[lev], 0, 0, AMREX_SPACEDIM, 0);
+
+            ComputeDivTau(lev, *divtau_in[lev], vel);
+            ScaleByLocalTimeStep(lev, *divtau_in[lev]);
+        }
+    }
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        scratch.release(std::move(vel_rhs[lev]));
+        scratch.release(std::move(vel_prev[lev]));
+    }
+
+    return converged;
+}
@@ -10,10 +10,105 @@ module eb_wallflux_mod
    implicit none
 
    private
-   public      :: compute_diff_wallflux
+   public      :: compute_diff_wallflux, compute_eb_wall_traction
 
 contains
 
+   !
+   ! Velocity gradient on the wall of cut cell (i,j,k): gradu(n,m) = d(u_n)/d(x_m).
+   ! We use no-slip boundary for velocities, so only the normal derivatives are nonzero.
+   ! Also returns the difference in area fraction across the cell, which is the
+   ! area-weighted wall normal pointing into the fluid.
+   !
+   subroutine compute_eb_wall_gradient(gradu, dap, dx, i, j, k, &
+                                       vel,    vlo,  vhi, &
+                                       bcent,  blo,  bhi, &
+                                       flag,   flo,  fhi, &
+                                       apx,   axlo, axhi, &
+                                       apy,   aylo, ayhi, &
+                                       apz,   azlo, azhi, &
+                                       vfrac, vflo, vfhi, &
+                                       cyl_speed)
+
+      real(rt),       intent(  out) :: gradu(3,3), dap(3)
+
+      ! Cell indices
+      integer(c_int), intent(in   ) :: i, j, k
+
+      ! Grid spacing
+      real(rt),       intent(in   ) :: dx(3)
+
+      ! Array bounds
+      integer(c_int), intent(in   ) ::  vlo(3),  vhi(3)
+      integer(c_int), intent(in   ) :: axlo(3), axhi(3)
+      integer(c_int), intent(in   ) :: aylo(3), ayhi(3)
+      integer(c_int), intent(in   ) :: azlo(3), azhi(3)
+      integer(c_int), intent(in   ) :: vflo(3), vfhi(3)
+      integer(c_int), intent(in   ) ::  blo(3),  bhi(3)
+      integer(c_int), intent(in   ) ::  flo(3),  fhi(3)
+
+      ! Arrays
+      real(rt),       intent(in   ) ::                                 &
+           &   vel( vlo(1): vhi(1), vlo(2): vhi(2), vlo(3): vhi(3),3), &
+           & bcent( blo(1): bhi(1), blo(2): bhi(2), blo(3): bhi(3),3), &
+           &   apx(axlo(1):axhi(1),axlo(2):axhi(2),axlo(3):axhi(3)  ), &
+           &   apy(aylo(1):ayhi(1),aylo(2):ayhi(2),aylo(3):ayhi(3)  ), &
+           &   apz(azlo(1):azhi(1),azlo(2):azhi(2),azlo(3):azhi(3)  ), & 
+           & vfrac(vflo(1):vfhi(1),vflo(2):vfhi(2),vflo(3):vfhi(3)  )
+
+      integer(c_int), intent(in   ) :: flag(flo(1):fhi(1),flo(2):fhi(2),flo(3):fhi(3))
+
+      ! Rotating cylinder 
+      real(rt),       intent(in   ) :: cyl_speed
+
+      ! Local variable
+      real(rt)   :: dxinv(3)
+      real(rt)   :: apnorm, apnorminv, anrm(3)
+      real(rt)   :: dudn(3), velb(3)
+      real(rt)   :: theta
+      integer    :: n
+
+      dxinv = one / dx
+
+      ! Difference in area fraction across cell
+      dap(1) = apx(i+1,j  ,k  ) - apx(i,j,k)
+      dap(2) = apy(i  ,j+1,k  ) - apy(i,j,k)
+      dap(3) = apz(i  ,j  ,k+1) - apz(i,j,k)
+
+      apnorm = sqrt(dap(1)**2 + dap(2)**2 + dap(3)**2)
+
+      if ( apnorm == zero ) then
+         call amrex_abort("compute_eb_wall_gradient: we are in trouble.")
+      end if
+
+      apnorminv = one/apnorm
+      anrm = -dap * apnorminv  ! unit vector pointing toward the wall
+
+      ! Value on wall 
+      velb  = zero
+      theta = zero
+      if (cyl_speed > zero) then
+         theta = atan2(-anrm(2), -anrm(1))
+         velb(1) =   cyl_speed * sin(theta)
+         velb(2) = - cyl_speed * cos(theta)
+      endif
+
+      do n = 1, 3
+         call compute_dphidn_3d(dudn(n), dxinv, i, j, k, &
+                                vel(:,:,:,n), vlo, vhi, &
+                                flag, flo, fhi, &
+                                bcent(i,j,k,:), velb(n),  &
+                                anrm(1), anrm(2), anrm(3), vfrac(i,j,k))
+      end do
+
+      !
+      ! transform them to d/dx, d/dy and d/dz given transverse derivatives are zero
+      do n = 1, 3
+         gradu(n,:) = dudn(n) * anrm(:) * dxinv(:)
+      end do
+
+   end subroutine compute_eb_wall_gradient
+
    !
    ! We use no-slip boundary for velocities.
    !
@@ -60,84 +155,41 @@ contains
       real(rt),       intent(in   ) :: cyl_speed
 
       ! Local variable
-      real(rt)   :: dxinv(3), idx, idy, idz
-      real(rt)   :: dapx, dapy, dapz
-      real(rt)   :: apnorm, apnorminv, anrmx, anrmy, anrmz
-      real(rt)   :: dudn, dvdn, dwdn
+      real(rt)   :: gradu(3,3), dap(3)
       real(rt)   :: ux, uy, uz, vx, vy, vz, wx, wy, wz
       real(rt)   :: tauxx, tauxy, tauxz, tauyx, tauyy, tauyz, tauzx, tauzy, tauzz
       real(rt)   :: strain, visc
-      real(rt)   :: ub, vb, wb, theta
 
       divw  = zero
-      dxinv = one / dx
-
-      idx = dxinv(1)
-      idy = dxinv(2)
-      idz = dxinv(3)
-
-      dapx = apx(i+1,j  ,k  ) - apx(i,j,k)
-      dapy = apy(i  ,j+1,k  ) - apy(i,j,k)
-      dapz = apz(i  ,j  ,k+1) - apz(i,j,k)
 
-      apnorm = sqrt(dapx**2 + dapy**2 + dapz**2)
-
-      if ( apnorm == zero ) then
-         call amrex_abort("compute_diff_wallflux: we are in trouble.")
-      end if
-
-      apnorminv = one/apnorm
-      anrmx = -dapx * apnorminv  ! unit vector pointing toward the wall
-      anrmy = -dapy * apnorminv
-      anrmz = -dapz * apnorminv
-
-      ! Value on wall 
-      ub = 0.d0
-      vb = 0.d0
-      wb = 0.d0
-      theta = 0.d0
-      if (cyl_speed > 0.d0) then
-         theta = atan2(-anrmy, -anrmx)
-         ub =   cyl_speed * sin(theta)
-         vb = - cyl_speed * cos(theta)
-      endif
-
-
-      call compute_dphidn_3d(dudn, dxinv, i, j, k, &
-                             vel(:,:,:,1), vlo, vhi, &
-                             flag, flo, fhi, &
-                             bcent(i,j,k,:), ub,  &
-                             anrmx, anrmy, anrmz, vfrac(i,j,k))
-      call compute_dphidn_3d(dvdn, dxinv, i, j, k, &
-                             vel(:,:,:,2), vlo, vhi, &
-                             flag, flo, fhi, &
-                             bcent(i,j,k,:), vb,  &
-                             anrmx, anrmy, anrmz, vfrac(i,j,k))
-      call compute_dphidn_3d(dwdn, dxinv, i, j, k, &
-                             vel(:,:,:,3), vlo, vhi, &
-                             flag, flo, fhi, &
-                             bcent(i,j,k,:), wb,  &
-                             anrmx, anrmy, anrmz, vfrac(i,j,k))
+      call compute_eb_wall_gradient(gradu, dap, dx, i, j, k, &
+                                    vel,    vlo,  vhi, &
+                                    bcent,  blo,  bhi, &
+                                    flag,   flo,  fhi, &
+                                    apx,   axlo, axhi, &
+                                    apy,   aylo, ayhi, &
+                                    apz,   azlo, azhi, &
+                                    vfrac, vflo, vfhi, &
+                                    cyl_speed)
 
-      !
-      ! transform them to d/dx, d/dy and d/dz given transverse derivatives are zero
-      ux = dudn * anrmx * idx
-      uy = dudn * anrmy * idy
-      uz = dudn * anrmz * idz
+      ux = gradu(1,1)
+      uy = gradu(1,2)
+      uz = gradu(1,3)
       !                       
-      vx = dvdn * anrmx * idx
-      vy = dvdn * anrmy * idy
-      vz = dvdn * anrmz * idz
+      vx = gradu(2,1)
+      vy = gradu(2,2)
+      vz = gradu(2,3)
       !                       
-      wx = dwdn * anrmx * idx
-      wy = dwdn * anrmy * idy
-      wz = dwdn * anrmz * idz
+      wx = gradu(3,1)
+      wy = gradu(3,2)
+      wz = gradu(3,3)
 
       strain = sqrt(two * ux**2 + two * vy**2 + two * wz**2 + &
                     (uy + vx)**2 + (vz + wy)**2 + (wx + uz)**2) 
       visc = viscosity(strain)
 
       ! compute components of EXPLICIT PART OF stress tensor on the wall
+      ! (the normal derivative part is in the implicit operator)
       tauxx = visc * ux 
       tauxy = visc * vx
       tauxz = visc * wx
@@ -150,16 +202,78 @@ contains
       tauzy = visc * vz
       tauzz = visc * wz
 
-      ! Difference in area fraction across cell, used to find the divergence
-      dapx = apx(i+1,j,k)-apx(i,j,k)
-      dapy = apy(i,j+1,k)-apy(i,j,k)
-      dapz = apz(i,j,k+1)-apz(i,j,k)
-
       ! Return the divergence of the stress tensor 
-      divw(1) = dapx * tauxx + dapy * tauxy + dapz * tauxz
-      divw(2) = dapx * tauyx + dapy * tauyy + dapz * tauyz
-      divw(3) = dapx * tauzx + dapy * tauzy + dapz * tauzz
+      divw(1) = dap(1) * tauxx + dap(2) * tauxy + dap(3) * tauxz
+      divw(2) = dap(1) * tauyx + dap(2) * tauyy + dap(3) * tauyz
+      divw(3) = dap(1) * tauzx + dap(2) * tauzy + dap(3) * tauzz
 
    end subroutine compute_diff_wallflux
 
+   !
+   ! Viscous force per unit dx**2 exerted by the fluid on the wall in cut cell (i,j,k),
+   ! eta * (grad u + grad u^T) . n, with the same wall gradient as the viscous operator.
+   ! For the force and torque monitor.
+   !
+   subroutine compute_eb_wall_traction(traction, i, j, k, dx, &
+                                       vel,    vlo,  vhi, &
+                                       bcent,  blo,  bhi, &
+                                       flag,   flo,  fhi, &
+                                       apx,   axlo, axhi, &
+                                       apy,   aylo, ayhi, &
+                                       apz,   azlo, azhi, &
+                                       vfrac, vflo, vfhi, &
+                                       cyl_speed) bind(C)
+
+      real(rt),       intent(  out) :: traction(3)
+
+      integer(c_int), intent(in   ) :: i, j, k
+
+      real(rt),       intent(in   ) :: dx(3)
+
+      integer(c_int), intent(in   ) ::  vlo(3),  vhi(3)
+      integer(c_int), intent(in   ) :: axlo(3), axhi(3)
+      integer(c_int), intent(in   ) :: aylo(3), ayhi(3)
+      integer(c_int), intent(in   ) :: azlo(3), azhi(3)
+      integer(c_int), intent(in   ) :: vflo(3), vfhi(3)
+      integer(c_int), intent(in   ) ::  blo(3),  bhi(3)
+      integer(c_int), intent(in   ) ::  flo(3),  fhi(3)
+
+      real(rt),       intent(in   ) ::                                 &
+           &   vel( vlo(1): vhi(1), vlo(2): vhi(2), vlo(3): vhi(3),3), &
+           & bcent( blo(1): bhi(1), blo(2): bhi(2), blo(3): bhi(3),3), &
+           &   apx(axlo(1):axhi(1),axlo(2):axhi(2),axlo(3):axhi(3)  ), &
+           &   apy(aylo(1):ayhi(1),aylo(2):ayhi(2),aylo(3):ayhi(3)  ), &
+           &   apz(azlo(1):azhi(1),azlo(2):azhi(2),azlo(3):azhi(3)  ), &
+           & vfrac(vflo(1):vfhi(1),vflo(2):vfhi(2),vflo(3):vfhi(3)  )
+
+      integer(c_int), intent(in   ) :: flag(flo(1):fhi(1),flo(2):fhi(2),flo(3):fhi(3))
+
+      real(rt),       intent(in   ) :: cyl_speed
+
+      real(rt)   :: gradu(3,3), dap(3), strain, visc
+      integer    :: n
+
+      call compute_eb_wall_gradient(gradu, dap, dx, i, j, k, &
+                                    vel,    vlo,  vhi, &
+                                    bcent,  blo,  bhi, &
+                                    flag,   flo,  fhi, &
+                                    apx,   axlo, axhi, &
+                                    apy,   aylo, ayhi, &
+                                    apz,   azlo, azhi, &
+                                    vfrac, vflo, vfhi, &
+                                    cyl_speed)
+
+      strain = sqrt(two * gradu(1,1)**2 + two * gradu(2,2)**2 + two * gradu(3,3)**2 + &
+                    (gradu(1,2) + gradu(2,1))**2 + (gradu(2,3) + gradu(3,2))**2 + &
+                    (gradu(3,1) + gradu(1,3))**2)
+      visc = viscosity(strain)
+
+      ! The area-weighted normal points out of the body, into the fluid, so this is the
+      ! force on the wall. Both the normal derivative (wall shear) and the transpose part.
+      do n = 1, 3
+         traction(n) = visc * sum( (gradu(n,:) + gradu(:,n)) * dap(:) )
+      end do
+
+   end subroutine compute_eb_wall_traction
+
 end module eb_wallflux_mod
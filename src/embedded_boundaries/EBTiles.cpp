@@ -0,0 +1,103 @@
+#include <EBTiles.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+EBTiles::EBTiles(const EBFArrayBoxFactory& factory, int max_grow)
+    : m_ba(factory.boxArray())
+    , m_dm(factory.DistributionMap())
+    , m_tile_size(FabArrayBase::mfiter_tile_size)
+{
+    BL_PROFILE("EBTiles::EBTiles()");
+
+    const FabArray<EBCellFlagFab>& flags = factory.getMultiEBCellFlagFab();
+
+    m_tiles.resize(MFIter(m_ba, m_dm, TilingIfNotGPU()).length());
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for(MFIter mfi(m_ba, m_dm, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        Tile& t = m_tiles[mfi.LocalTileIndex()];
+        t.box = mfi.tilebox();
+
+        const EBCellFlagFab& flag = flags[mfi];
+
+        // Boxes without cut cells: all tiles and halos have the type of the box
+        const FabType box_type = flag.getType();
+        if(box_type == FabType::regular || box_type == FabType::covered)
+        {
+            t.type.assign(max_grow + 1, box_type);
+            if(box_type == FabType::regular) t.regular.push_back(t.box);
+            continue;
+        }
+
+        AMREX_ASSERT(max_grow >= 1);
+        t.type.resize(max_grow + 1);
+        for(int n = 0; n <= max_grow; n++)
+        {
+            t.type[n] = flag.getType(amrex::grow(t.box, n));
+        }
+
+        if(t.type[0] != FabType::covered) split(flag, t);
+
+        if(t.type[0] != FabType::singlevalued) continue;
+
+        const auto& flag_arr = flag.array();
+        const Box& bx = t.box;
+        for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+        for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+        for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+        {
+            if(flag_arr(i,j,k).isSingleValued()) t.cut.push_back(IntVect(i,j,k));
+        }
+    }
+}
+
+void EBTiles::split(const EBCellFlagFab& flag, Tile& t)
+{
+    const Box& bx = t.box;
+
+    if(t.type[1] == FabType::regular)
+    {
+        t.regular.push_back(bx);
+        return;
+    }
+
+    // Slabs across the longest side whose cells only have regular neighbours
+    int dir;
+    const int n = bx.longside(dir);
+    const int lo = bx.smallEnd(dir);
+
+    Vector<int> regular(n);
+    for(int s = 0; s < n; s++)
+    {
+        Box slab(bx);
+        slab.setRange(dir, lo + s);
+        regular[s] = (flag.getType(amrex::grow(slab, 1)) == FabType::regular);
+    }
+
+    // Short regular runs are left to the EB kernel, they would cost more in halo than they save
+    const int min_run = 4;
+    for(int s = 0, e; s < n; s = e)
+    {
+        for(e = s; e < n && regular[e] == regular[s]; e++);
+        if(regular[s] && e - s < min_run) std::fill(regular.begin() + s, regular.begin() + e, 0);
+    }
+
+    for(int s = 0, e; s < n; s = e)
+    {
+        for(e = s; e < n && regular[e] == regular[s]; e++);
+
+        Box part(bx);
+        part.setRange(dir, lo + s, e - s);
+        (regular[s] ? t.regular : t.eb).push_back(part);
+    }
+}
+
+bool EBTiles::compatible(const BoxArray& ba, const DistributionMapping& dm) const
+{
+    return ba == m_ba && dm == m_dm && FabArrayBase::mfiter_tile_size == m_tile_size;
+}
@@ -0,0 +1,511 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EBCellFlag.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include <embedded_boundaries_F.H>
+#include <incflo.H>
+
+void GotoNextLine(std::istream& is);
+
+//
+// EB geometry cache
+//
+// EB2::Build computes the EB data (cell flags, volume and area fractions, centroids, ...) of
+// the finest level and of all its coarsenings. With incflo.eb_cache_dir set, this data is
+// written to <eb_cache_dir>/eb_<hash>/ after the index space has been built, and read back
+// instead of building it again the next time incflo runs with the same geometry parameters,
+// eb2.* options, domain, resolution and max_level. The hash is that of a key made of these
+// parameters. The full key is stored with the data and compared on reading, together with a
+// checksum of the data. Any mismatch or missing file falls back to building the index space.
+//
+// EB2 has no public way to make a level from existing data, so the cached levels set the
+// protected members of EB2::Level that its fill functions read. This ties the cache to the
+// layout of EB2::Level in the AMReX it is built with: the AMReX version is part of the key, so
+// that a cache is only ever read back by the AMReX that wrote it, and the eb_cache unit check
+// (test/unit_checks) compares a reloaded index space with the built one for the AMReX under test.
+//
+namespace
+{
+    const std::string cache_version{"incflo EB cache version 1"};
+
+    const int max_coarsening_level = 100;
+
+    // 64-bit FNV-1a hash, only used to name the cache directory
+    std::string HashKey(const std::string& key)
+    {
+        std::uint64_t h = 14695981039346656037ULL;
+        for(unsigned char c : key)
+        {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        std::ostringstream os;
+        os << std::hex << std::setw(16) << std::setfill('0') << h;
+        return os.str();
+    }
+
+    std::string LevelPrefix(const std::string& dir, int ilev)
+    {
+        return dir + "/Level_" + std::to_string(ilev) + "/";
+    }
+
+    const Vector<std::string> face_suffix = {"_x", "_y", "_z"};
+
+    // The EB data of one level of the index space, on the grids of that level
+    struct LevelData
+    {
+        MultiFab cellflag;      // EBCellFlag words, stored exactly as doubles
+        MultiFab volfrac;
+        MultiFab centroid;
+        MultiFab bndryarea;
+        MultiFab bndrycent;
+        MultiFab bndrynorm;
+        Array<MultiFab, AMREX_SPACEDIM> areafrac;
+        Array<MultiFab, AMREX_SPACEDIM> facecent;
+
+        void define(const BoxArray& ba, const DistributionMapping& dm)
+        {
+            cellflag.define(ba, dm, 1, 0);
+            volfrac.define(ba, dm, 1, 0);
+            centroid.define(ba, dm, AMREX_SPACEDIM, 0);
+            bndryarea.define(ba, dm, 1, 0);
+            bndrycent.define(ba, dm, AMREX_SPACEDIM, 0);
+            bndrynorm.define(ba, dm, AMREX_SPACEDIM, 0);
+            for(int d = 0; d < AMREX_SPACEDIM; d++)
+            {
+                const BoxArray face_ba = amrex::convert(ba, IntVect::TheDimensionVector(d));
+                areafrac[d].define(face_ba, dm, 1, 0);
+                facecent[d].define(face_ba, dm, AMREX_SPACEDIM - 1, 0);
+            }
+        }
+
+        Vector<MultiFab*> all()
+        {
+            Vector<MultiFab*> r = {&cellflag, &volfrac, &centroid, &bndryarea, &bndrycent, &bndrynorm};
+            for(int d = 0; d < AMREX_SPACEDIM; d++) r.push_back(&areafrac[d]);
+            for(int d = 0; d < AMREX_SPACEDIM; d++) r.push_back(&facecent[d]);
+            return r;
+        }
+
+        Vector<std::string> names() const
+        {
+            Vector<std::string> r = {"cellflag", "volfrac", "centroid", "bndryarea", "bndrycent", "bndrynorm"};
+            for(int d = 0; d < AMREX_SPACEDIM; d++) r.push_back("areafrac" + face_suffix[d]);
+            for(int d = 0; d < AMREX_SPACEDIM; d++) r.push_back("facecent" + face_suffix[d]);
+            return r;
+        }
+
+        // Sum of each array, over all components
+        Vector<Real> checksum()
+        {
+            Vector<Real> sums;
+            for(MultiFab* mf : all())
+            {
+                Real sum = 0.0;
+                for(int n = 0; n < mf->nComp(); n++) sum += mf->sum(n);
+                sums.push_back(sum);
+            }
+            return sums;
+        }
+    };
+
+    static_assert(sizeof(EBCellFlag) == sizeof(std::uint32_t), "EBCellFlag is not a 32-bit word");
+
+    //
+    // Level of the index space made from cached data. The fill functions of EB2::Level,
+    // which the EB factories use, work on the data set here as they do on a built level.
+    //
+    class CachedLevel : public EB2::Level
+    {
+    public:
+        CachedLevel(const EB2::IndexSpace* is, const Geometry& geom, bool allregular, LevelData& data)
+            : EB2::Level(is, geom)
+        {
+            m_allregular = allregular;
+            m_ok = true;
+
+            if(allregular) return;
+
+            m_grids = data.volfrac.boxArray();
+            m_dmap = data.volfrac.DistributionMap();
+
+            // Boxes without fluid are left out of the grids of a level
+            BoxList covered = amrex::complementIn(geom.Domain(), BoxList(m_grids));
+            if(covered.isNotEmpty()) m_covered_grids = BoxArray(std::move(covered));
+
+            m_cellflag.define(m_grids, m_dmap, 1, 0);
+            for(MFIter mfi(m_cellflag); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.validbox();
+                EBCellFlagFab& flag = m_cellflag[mfi];
+                const FArrayBox& word = data.cellflag[mfi];
+                for(IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+                {
+                    std::uint32_t w = static_cast<std::uint32_t>(word(iv));
+                    std::memcpy(&flag(iv), &w, sizeof(w));
+                }
+            }
+
+            m_volfrac = std::move(data.volfrac);
+            m_centroid = std::move(data.centroid);
+            m_bndryarea = std::move(data.bndryarea);
+            m_bndrycent = std::move(data.bndrycent);
+            m_bndrynorm = std::move(data.bndrynorm);
+            for(int d = 0; d < AMREX_SPACEDIM; d++)
+            {
+                m_areafrac[d] = std::move(data.areafrac[d]);
+                m_facecent[d] = std::move(data.facecent[d]);
+            }
+        }
+    };
+
+    //
+    // Index space made from cached levels, finest first
+    //
+    class CachedIndexSpace : public EB2::IndexSpace
+    {
+    public:
+        void addLevel(const Geometry& geom, bool allregular, LevelData& data)
+        {
+            m_geom.push_back(geom);
+            m_level.emplace_back(new CachedLevel(this, geom, allregular, data));
+        }
+
+        const EB2::Level& getLevel(const Geometry& geom) const
+        {
+            return *m_level[index(geom.Domain())];
+        }
+
+        const Geometry& getGeometry(const Box& domain) const
+        {
+            return m_geom[index(domain)];
+        }
+
+        const Box& coarsestDomain() const
+        {
+            return m_geom.back().Domain();
+        }
+
+        void addFineLevels(int num_new_fine_levels)
+        {
+            amrex::Abort("EB geometry cache: cannot add fine levels to a cached index space");
+        }
+
+    private:
+        int index(const Box& domain) const
+        {
+            for(int i = 0; i < m_geom.size(); i++)
+            {
+                if(m_geom[i].Domain() == domain) return i;
+            }
+            amrex::Abort("EB geometry cache: no level with this domain");
+            return -1;
+        }
+
+        Vector<Geometry> m_geom;
+        Vector<std::unique_ptr<CachedLevel>> m_level;
+    };
+}
+
+//
+// Everything the EB index space depends on
+//
+std::string incflo::EBCacheKey(const std::string& geom_type) const
+{
+    std::ostringstream key;
+    key.precision(17);
+
+    key << cache_version << "\n";
+    key << "amrex " << amrex::Version() << "\n";
+    key << "geometry " << geom_type << "\n";
+
+    // Parameters of the geometry (sphere.radius, cylinder.center, ...) and the options of
+    // EB2::Build (eb2.small_volfrac, ...)
+    {
+        std::ostringstream table;
+        ParmParse::dumpTable(table);
+        std::istringstream lines(table.str());
+        std::string line;
+        while(std::getline(lines, line))
+        {
+            const bool geom_param = !geom_type.empty() &&
+                                    line.compare(0, geom_type.size() + 1, geom_type + ".") == 0;
+            const bool eb2_param = line.compare(0, 4, "eb2.") == 0;
+            if(geom_param || eb2_param) key << line << "\n";
+        }
+    }
+
+    // Geometries read from a file (stl, tubebundle): its contents, not just its name
+    std::string geom_file;
+    if(!geom_type.empty() && ParmParse(geom_type).query("file", geom_file))
+    {
+        Vector<char> chars;
+        ParallelDescriptor::ReadAndBcastFile(geom_file, chars);
+        key << "file_hash " << HashKey(std::string(chars.begin(), chars.end())) << "\n";
+    }
+
+    // Walls from the BCs
+    for(int i = 1; i <= 6; i++)
+    {
+        int exists;
+        RealVect normal, center;
+        incflo_get_real_walls(&i, &exists, &normal, &center);
+        if(exists) key << "wall " << i << " " << normal << " " << center << "\n";
+    }
+
+    const Geometry& fine_geom = geom.back();
+    key << "domain " << fine_geom.Domain() << "\n";
+    key << "prob_lo";
+    for(int d = 0; d < AMREX_SPACEDIM; d++) key << " " << fine_geom.ProbLo(d);
+    key << "\nprob_hi";
+    for(int d = 0; d < AMREX_SPACEDIM; d++) key << " " << fine_geom.ProbHi(d);
+    key << "\nperiodic";
+    for(int d = 0; d < AMREX_SPACEDIM; d++) key << " " << fine_geom.isPeriodic(d);
+    key << "\nmax_level " << max_level << "\n";
+    key << "max_coarsening_level " << max_coarsening_level << "\n";
+
+    return key.str();
+}
+
+//
+// Read the index space from the cache and make it the current one. Returns false (and leaves
+// the index space alone) if there is no valid cache for key.
+//
+bool incflo::ReadEBCache(const std::string& key)
+{
+    BL_PROFILE("incflo::ReadEBCache()");
+
+    const std::string dir = eb_cache_dir + "/eb_" + HashKey(key);
+
+    if(!amrex::FileExists(dir + "/Header") || !amrex::FileExists(dir + "/Key"))
+    {
+        amrex::Print() << "\n No EB geometry cache in " << dir << std::endl;
+        return false;
+    }
+
+    Vector<char> key_chars;
+    ParallelDescriptor::ReadAndBcastFile(dir + "/Key", key_chars);
+    if(std::string(key_chars.dataPtr()) != key)
+    {
+        amrex::Print() << "\n EB geometry cache " << dir << " is for other parameters, rebuilding" << std::endl;
+        return false;
+    }
+
+    Vector<char> header_chars;
+    ParallelDescriptor::ReadAndBcastFile(dir + "/Header", header_chars);
+    std::istringstream is(std::string(header_chars.dataPtr()), std::istringstream::in);
+
+    std::string line;
+    std::getline(is, line);
+    if(line != cache_version)
+    {
+        amrex::Print() << "\n EB geometry cache " << dir << " has another version, rebuilding" << std::endl;
+        return false;
+    }
+
+    int nlevels;
+    is >> nlevels;
+    GotoNextLine(is);
+
+    const Geometry& fine_geom = geom.back();
+    Array<int, AMREX_SPACEDIM> is_per = {AMREX_D_DECL(fine_geom.isPeriodic(0),
+                                                      fine_geom.isPeriodic(1),
+                                                      fine_geom.isPeriodic(2))};
+
+    std::unique_ptr<CachedIndexSpace> index_space(new CachedIndexSpace);
+
+    for(int ilev = 0; ilev < nlevels; ilev++)
+    {
+        Box domain;
+        int allregular;
+        is >> domain >> allregular;
+
+        LevelData data;
+        Vector<Real> checksum(data.names().size());
+        for(Real& sum : checksum) is >> sum;
+        GotoNextLine(is);
+
+        if(ilev == 0 && domain != fine_geom.Domain())
+        {
+            amrex::Print() << "\n EB geometry cache " << dir << " is for another domain, rebuilding" << std::endl;
+            return false;
+        }
+
+        Geometry level_geom(domain, &fine_geom.ProbDomain(), fine_geom.Coord(), is_per.data());
+
+        if(!allregular)
+        {
+            const std::string prefix = LevelPrefix(dir, ilev);
+            const Vector<std::string> names = data.names();
+            for(const std::string& name : names)
+            {
+                if(!amrex::FileExists(prefix + name + "_H"))
+                {
+                    amrex::Print() << "\n EB geometry cache " << dir << " is incomplete, rebuilding" << std::endl;
+                    return false;
+                }
+            }
+
+            // The grids and distribution of the level come with volfrac
+            MultiFab volfrac;
+            VisMF::Read(volfrac, prefix + "volfrac");
+            data.define(volfrac.boxArray(), volfrac.DistributionMap());
+            data.volfrac = std::move(volfrac);
+
+            const Vector<MultiFab*> mfs = data.all();
+            for(int i = 0; i < mfs.size(); i++)
+            {
+                if(mfs[i] != &data.volfrac) VisMF::Read(*mfs[i], prefix + names[i]);
+            }
+
+            // Up to round-off, the sums may be done in another order than when writing
+            const Vector<Real> sums = data.checksum();
+            for(int i = 0; i < sums.size(); i++)
+            {
+                if(std::abs(sums[i] - checksum[i]) > 1.e-10 * std::max(std::abs(checksum[i]), Real(1.0)))
+                {
+                    amrex::Print() << "\n EB geometry cache " << dir << " failed the checksum, rebuilding" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        index_space->addLevel(level_geom, allregular, data);
+    }
+
+    EB2::IndexSpace::push(index_space.release());
+
+    amrex::Print() << "\n Read EB geometry from cache " << dir << std::endl;
+
+    return true;
+}
+
+//
+// Write the current index space to the cache
+//
+void incflo::WriteEBCache(const std::string& key) const
+{
+    BL_PROFILE("incflo::WriteEBCache()");
+
+    const std::string dir = eb_cache_dir + "/eb_" + HashKey(key);
+
+    const EB2::IndexSpace& eb_is = EB2::IndexSpace::top();
+
+    // Levels of the index space: the finest domain and its coarsenings by 2
+    Vector<Box> domains;
+    Box domain = geom.back().Domain();
+    while(true)
+    {
+        domains.push_back(domain);
+        if(domain == eb_is.coarsestDomain()) break;
+        domain.coarsen(2);
+    }
+
+    const int nlevels = domains.size();
+
+    amrex::PreBuildDirectorHierarchy(dir, "Level_", nlevels, true);
+
+    // The key of a previous, invalid cache in the same directory must not outlive its data
+    if(ParallelDescriptor::IOProcessor() && amrex::FileExists(dir + "/Key"))
+    {
+        std::remove((dir + "/Key").c_str());
+    }
+    ParallelDescriptor::Barrier();
+
+    Vector<int> allregular(nlevels);
+    Vector<Vector<Real>> checksum(nlevels, Vector<Real>(LevelData().names().size(), 0.0));
+
+    for(int ilev = 0; ilev < nlevels; ilev++)
+    {
+        const Geometry& level_geom = eb_is.getGeometry(domains[ilev]);
+        const EB2::Level& eb_level = eb_is.getLevel(level_geom);
+
+        allregular[ilev] = eb_level.isAllRegular();
+        if(allregular[ilev]) continue;
+
+        const BoxArray& ba = eb_level.boxArray();
+        const DistributionMapping& dm = eb_level.DistributionMap();
+
+        LevelData data;
+        data.define(ba, dm);
+
+        FabArray<EBCellFlagFab> cellflag(ba, dm, 1, 0);
+        eb_level.fillEBCellFlag(cellflag, level_geom);
+        for(MFIter mfi(cellflag); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const EBCellFlagFab& flag = cellflag[mfi];
+            FArrayBox& word = data.cellflag[mfi];
+            for(IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+            {
+                std::uint32_t w;
+                std::memcpy(&w, &flag(iv), sizeof(w));
+                word(iv) = static_cast<Real>(w);
+            }
+        }
+
+        eb_level.fillVolFrac(data.volfrac, level_geom);
+        eb_level.fillCentroid(data.centroid, level_geom);
+        eb_level.fillBndryArea(data.bndryarea, level_geom);
+        eb_level.fillBndryCent(data.bndrycent, level_geom);
+        eb_level.fillBndryNorm(data.bndrynorm, level_geom);
+
+        Array<MultiFab*, AMREX_SPACEDIM> areafrac, facecent;
+        for(int d = 0; d < AMREX_SPACEDIM; d++)
+        {
+            areafrac[d] = &data.areafrac[d];
+            facecent[d] = &data.facecent[d];
+        }
+        eb_level.fillAreaFrac(areafrac, level_geom);
+        eb_level.fillFaceCent(facecent, level_geom);
+
+        checksum[ilev] = data.checksum();
+
+        const std::string prefix = LevelPrefix(dir, ilev);
+        const Vector<std::string> names = data.names();
+        const Vector<MultiFab*> mfs = data.all();
+        for(int i = 0; i < mfs.size(); i++)
+        {
+            VisMF::Write(*mfs[i], prefix + names[i]);
+        }
+    }
+
+    // Header and then key last, so that an interrupted write leaves no valid cache
+    if(ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream HeaderFile((dir + "/Header").c_str(), std::ofstream::out | std::ofstream::trunc);
+        if(!HeaderFile.good())
+            amrex::FileOpenFailed(dir + "/Header");
+
+        HeaderFile.precision(17);
+        HeaderFile << cache_version << "\n";
+        HeaderFile << nlevels << "\n";
+        for(int ilev = 0; ilev < nlevels; ilev++)
+        {
+            HeaderFile << domains[ilev] << " " << allregular[ilev];
+            for(Real sum : checksum[ilev]) HeaderFile << " " << sum;
+            HeaderFile << "\n";
+        }
+        HeaderFile.close();
+
+        std::ofstream KeyFile((dir + "/Key").c_str(), std::ofstream::out | std::ofstream::trunc);
+        if(!KeyFile.good())
+            amrex::FileOpenFailed(dir + "/Key");
+        KeyFile << key;
+        KeyFile.close();
+    }
+    ParallelDescriptor::Barrier();
+
+    amrex::Print() << "\n Wrote EB geometry to cache " << dir << std::endl;
+}
@@ -0,0 +1,453 @@
+#include <AMReX_EB2.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <eb_stl.H>
+#include <incflo.H>
+
+namespace
+{
+    inline RealArray sub(const RealArray& a, const RealArray& b)
+    {
+        return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    }
+
+    inline Real dot(const RealArray& a, const RealArray& b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    inline RealArray cross(const RealArray& a, const RealArray& b)
+    {
+        return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+    }
+
+    // Point of the triangle abc closest to p (Ericson, Real-Time Collision Detection, 5.1.5)
+    RealArray closestPoint(const RealArray& p, const RealArray& a, const RealArray& b, const RealArray& c)
+    {
+        const RealArray ab = sub(b, a);
+        const RealArray ac = sub(c, a);
+
+        const RealArray ap = sub(p, a);
+        const Real d1 = dot(ab, ap);
+        const Real d2 = dot(ac, ap);
+        if(d1 <= 0.0 && d2 <= 0.0) return a;
+
+        const RealArray bp = sub(p, b);
+        const Real d3 = dot(ab, bp);
+        const Real d4 = dot(ac, bp);
+        if(d3 >= 0.0 && d4 <= d3) return b;
+
+        const Real vc = d1 * d4 - d3 * d2;
+        if(vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+        {
+            const Real v = d1 / (d1 - d3);
+            return {a[0] + v * ab[0], a[1] + v * ab[1], a[2] + v * ab[2]};
+        }
+
+        const RealArray cp = sub(p, c);
+        const Real d5 = dot(ab, cp);
+        const Real d6 = dot(ac, cp);
+        if(d6 >= 0.0 && d5 <= d6) return c;
+
+        const Real vb = d5 * d2 - d1 * d6;
+        if(vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+        {
+            const Real w = d2 / (d2 - d6);
+            return {a[0] + w * ac[0], a[1] + w * ac[1], a[2] + w * ac[2]};
+        }
+
+        const Real va = d3 * d6 - d5 * d4;
+        if(va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+        {
+            const Real w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            return {b[0] + w * (c[0] - b[0]), b[1] + w * (c[1] - b[1]), b[2] + w * (c[2] - b[2])};
+        }
+
+        const Real denom = 1.0 / (va + vb + vc);
+        const Real v = vb * denom;
+        const Real w = vc * denom;
+        return {a[0] + ab[0] * v + ac[0] * w, a[1] + ab[1] * v + ac[1] * w, a[2] + ab[2] * v + ac[2] * w};
+    }
+
+    // Squared distance from p to the box [lo, hi]
+    inline Real boxDistance2(const RealArray& p, const RealArray& lo, const RealArray& hi)
+    {
+        Real d2 = 0.0;
+        for(int d = 0; d < 3; d++)
+        {
+            const Real e = std::max(std::max(lo[d] - p[d], p[d] - hi[d]), Real(0.0));
+            d2 += e * e;
+        }
+        return d2;
+    }
+
+    // Directions of the rays for the inside test: not aligned with the axes, so that rays
+    // don't run along the edges of meshes of axis-aligned faces
+    const RealArray ray_dir[3] = {{0.9283, 0.3178, 0.1932},
+                                  {0.2069, 0.9517, 0.2267},
+                                  {0.2744, 0.1543, 0.9492}};
+
+    // Traversal stack size, much more than the depth of a hierarchy of median splits
+    const int max_stack = 128;
+}
+
+STLMesh::STLMesh(const std::string& filename, Real scale, const RealArray& offset)
+{
+    read(filename, scale, offset);
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_tri.empty(), "STL file has no triangles");
+
+    build();
+}
+
+//
+// Read the triangles of an ASCII or binary STL file (on all ranks)
+//
+void STLMesh::read(const std::string& filename, Real scale, const RealArray& offset)
+{
+    Vector<char> chars;
+    ParallelDescriptor::ReadAndBcastFile(filename, chars);
+
+    // ReadAndBcastFile adds a null character at the end
+    const std::size_t nbytes = chars.size() - 1;
+
+    // Binary: 80 byte header, number of triangles, then 50 bytes per triangle
+    std::uint32_t nbinary = 0;
+    if(nbytes >= 84) std::memcpy(&nbinary, chars.dataPtr() + 80, sizeof(nbinary));
+
+    if(nbytes >= 84 && nbytes == 84 + 50 * std::size_t(nbinary))
+    {
+        m_tri.resize(nbinary);
+        const char* rec = chars.dataPtr() + 84;
+        for(std::uint32_t t = 0; t < nbinary; t++, rec += 50)
+        {
+            // Normal (ignored), three vertices
+            float v[12];
+            std::memcpy(v, rec, sizeof(v));
+            RealArray* vert[3] = {&m_tri[t].a, &m_tri[t].b, &m_tri[t].c};
+            for(int k = 0; k < 3; k++)
+            for(int d = 0; d < 3; d++)
+            {
+                (*vert[k])[d] = scale * v[3 + 3 * k + d] + offset[d];
+            }
+        }
+    }
+    else
+    {
+        // ASCII: only the vertex lines matter, three per facet
+        std::istringstream is(std::string(chars.dataPtr()));
+        std::string word;
+        Vector<RealArray> vertices;
+        while(is >> word)
+        {
+            if(word == "vertex")
+            {
+                RealArray x;
+                is >> x[0] >> x[1] >> x[2];
+                if(!is) amrex::Abort("Error reading vertex in STL file " + filename);
+                for(int d = 0; d < 3; d++) x[d] = scale * x[d] + offset[d];
+                vertices.push_back(x);
+            }
+        }
+
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(vertices.size() % 3 == 0,
+                                         "Number of vertices in STL file is not a multiple of 3");
+
+        m_tri.resize(vertices.size() / 3);
+        for(int t = 0; t < m_tri.size(); t++)
+        {
+            m_tri[t].a = vertices[3 * t];
+            m_tri[t].b = vertices[3 * t + 1];
+            m_tri[t].c = vertices[3 * t + 2];
+        }
+    }
+}
+
+//
+// Build the hierarchy by recursive median splits of the triangle centroids along the
+// longest extent, and reorder the triangles so that each leaf has a contiguous range
+//
+void STLMesh::build()
+{
+    const int ntri = m_tri.size();
+
+    Vector<RealArray> centroid(ntri);
+    Vector<int> index(ntri);
+    for(int t = 0; t < ntri; t++)
+    {
+        for(int d = 0; d < 3; d++)
+        {
+            centroid[t][d] = (m_tri[t].a[d] + m_tri[t].b[d] + m_tri[t].c[d]) / 3.0;
+        }
+        index[t] = t;
+    }
+
+    m_node.clear();
+    m_node.reserve(2 * (ntri / leaf_size + 1));
+    buildNode(0, ntri, centroid, index);
+
+    Vector<Triangle> sorted(ntri);
+    for(int t = 0; t < ntri; t++) sorted[t] = m_tri[index[t]];
+    std::swap(m_tri, sorted);
+}
+
+int STLMesh::buildNode(int first, int count, const Vector<RealArray>& centroid, Vector<int>& index)
+{
+    const int inode = m_node.size();
+    m_node.emplace_back();
+
+    Node node;
+    node.lo = { std::numeric_limits<Real>::max(),  std::numeric_limits<Real>::max(),  std::numeric_limits<Real>::max()};
+    node.hi = {-std::numeric_limits<Real>::max(), -std::numeric_limits<Real>::max(), -std::numeric_limits<Real>::max()};
+    RealArray clo = node.lo;
+    RealArray chi = node.hi;
+
+    for(int i = first; i < first + count; i++)
+    {
+        const Triangle& tri = m_tri[index[i]];
+        for(int d = 0; d < 3; d++)
+        {
+            node.lo[d] = std::min({node.lo[d], tri.a[d], tri.b[d], tri.c[d]});
+            node.hi[d] = std::max({node.hi[d], tri.a[d], tri.b[d], tri.c[d]});
+            clo[d] = std::min(clo[d], centroid[index[i]][d]);
+            chi[d] = std::max(chi[d], centroid[index[i]][d]);
+        }
+    }
+
+    if(count <= leaf_size)
+    {
+        node.right = -1;
+        node.first = first;
+        node.count = count;
+    }
+    else
+    {
+        int axis = 0;
+        for(int d = 1; d < 3; d++)
+        {
+            if(chi[d] - clo[d] > chi[axis] - clo[axis]) axis = d;
+        }
+
+        const int nleft = count / 2;
+        std::nth_element(index.begin() + first, index.begin() + first + nleft, index.begin() + first + count,
+                         [&](int i, int j) { return centroid[i][axis] < centroid[j][axis]; });
+
+        buildNode(first, nleft, centroid, index);
+        node.right = buildNode(first + nleft, count - nleft, centroid, index);
+        node.first = first;
+        node.count = 0;
+    }
+
+    m_node[inode] = node;
+    return inode;
+}
+
+Real STLMesh::distance(const RealArray& p, Real max_distance) const
+{
+    Real best2 = max_distance * max_distance;
+
+    int stack[max_stack];
+    int nstack = 0;
+    stack[nstack++] = 0;
+
+    while(nstack > 0)
+    {
+        const int inode = stack[--nstack];
+        const Node& node = m_node[inode];
+
+        if(boxDistance2(p, node.lo, node.hi) >= best2) continue;
+
+        if(node.count > 0)
+        {
+            for(int t = node.first; t < node.first + node.count; t++)
+            {
+                const RealArray q = closestPoint(p, m_tri[t].a, m_tri[t].b, m_tri[t].c);
+                const RealArray pq = sub(p, q);
+                best2 = std::min(best2, dot(pq, pq));
+            }
+        }
+        else
+        {
+            // Nearer child on top, so that it is searched first and prunes the other one
+            const int left = inode + 1;
+            const int right = node.right;
+            const Real dl = boxDistance2(p, m_node[left].lo, m_node[left].hi);
+            const Real dr = boxDistance2(p, m_node[right].lo, m_node[right].hi);
+
+            AMREX_ASSERT(nstack + 2 <= max_stack);
+            if(dl < dr)
+            {
+                stack[nstack++] = right;
+                stack[nstack++] = left;
+            }
+            else
+            {
+                stack[nstack++] = left;
+                stack[nstack++] = right;
+            }
+        }
+    }
+
+    return std::sqrt(best2);
+}
+
+bool STLMesh::inside(const RealArray& p) const
+{
+    const RealArray& lo = m_node[0].lo;
+    const RealArray& hi = m_node[0].hi;
+    for(int d = 0; d < 3; d++)
+    {
+        if(p[d] < lo[d] || p[d] > hi[d]) return false;
+    }
+
+    // Odd number of crossings: inside. Rays that graze an edge are tried in another direction.
+    int n = 0;
+    for(const RealArray& dir : ray_dir)
+    {
+        n = numCrossings(p, dir);
+        if(n >= 0) break;
+    }
+
+    return n > 0 && n % 2 == 1;
+}
+
+int STLMesh::numCrossings(const RealArray& p, const RealArray& dir) const
+{
+    const Real eps = 1.e-10;
+    const RealArray inv = {1.0 / dir[0], 1.0 / dir[1], 1.0 / dir[2]};
+
+    int ncross = 0;
+
+    int stack[max_stack];
+    int nstack = 0;
+    stack[nstack++] = 0;
+
+    while(nstack > 0)
+    {
+        const int inode = stack[--nstack];
+        const Node& node = m_node[inode];
+
+        // Slab test of the ray against the box of the node
+        Real tmin = 0.0;
+        Real tmax = std::numeric_limits<Real>::max();
+        for(int d = 0; d < 3; d++)
+        {
+            Real t0 = (node.lo[d] - p[d]) * inv[d];
+            Real t1 = (node.hi[d] - p[d]) * inv[d];
+            if(t0 > t1) std::swap(t0, t1);
+            tmin = std::max(tmin, t0);
+            tmax = std::min(tmax, t1);
+        }
+        if(tmin > tmax) continue;
+
+        if(node.count > 0)
+        {
+            // Moller-Trumbore
+            for(int t = node.first; t < node.first + node.count; t++)
+            {
+                const Triangle& tri = m_tri[t];
+                const RealArray e1 = sub(tri.b, tri.a);
+                const RealArray e2 = sub(tri.c, tri.a);
+                const RealArray h = cross(dir, e2);
+                const Real det = dot(e1, h);
+                if(std::abs(det) < eps * std::sqrt(dot(e1, e1) * dot(e2, e2))) continue;
+
+                const Real f = 1.0 / det;
+                const RealArray s = sub(p, tri.a);
+                const Real u = f * dot(s, h);
+                if(u < -eps || u > 1.0 + eps) continue;
+
+                const RealArray q = cross(s, e1);
+                const Real v = f * dot(dir, q);
+                if(v < -eps || u + v > 1.0 + eps) continue;
+
+                const Real tray = f * dot(e2, q);
+                if(tray <= 0.0) continue;
+
+                // Too close to an edge or vertex to tell whether it is crossed once or twice
+                if(u < eps || v < eps || u + v > 1.0 - eps) return -1;
+
+                ncross++;
+            }
+        }
+        else
+        {
+            AMREX_ASSERT(nstack + 2 <= max_stack);
+            stack[nstack++] = inode + 1;
+            stack[nstack++] = node.right;
+        }
+    }
+
+    return ncross;
+}
+
+/********************************************************************************
+ *                                                                              *
+ * Function to create an EB from a triangulated surface (STL file).             *
+ *                                                                              *
+ ********************************************************************************/
+void incflo::make_eb_stl()
+{
+    // Initialise STL parameters
+    std::string stl_file;
+    Real scale = 1.0;
+    Vector<Real> offsetvec(3, 0.0);
+    bool inside = false;
+
+    // Get STL information from inputs file.
+    ParmParse pp("stl");
+
+    pp.get("file", stl_file);
+    pp.query("scale", scale);
+    pp.queryarr("offset", offsetvec, 0, 3);
+    pp.query("internal_flow", inside);
+    RealArray offset = {offsetvec[0], offsetvec[1], offsetvec[2]};
+
+    // Print info about STL geometry
+	amrex::Print() << " " << std::endl;
+	amrex::Print() << " STL file:      " << stl_file << std::endl;
+	amrex::Print() << " Internal Flow: " << inside << std::endl;
+	amrex::Print() << " Scale:         " << scale << std::endl;
+	amrex::Print() << " Offset:        " << offset[0] << ", " << offset[1] << ", " << offset[2]
+				   << std::endl;
+
+    // Read the surface and build the hierarchy
+    Real start_time = ParallelDescriptor::second();
+    std::shared_ptr<const STLMesh> mesh = std::make_shared<STLMesh>(stl_file, scale, offset);
+    Real read_time = ParallelDescriptor::second() - start_time;
+    ParallelDescriptor::ReduceRealMax(read_time, ParallelDescriptor::IOProcessorNumber());
+
+	amrex::Print() << " Triangles:     " << mesh->numTriangles() << std::endl;
+	amrex::Print() << " Bounding box:  (" << mesh->lo()[0] << ", " << mesh->lo()[1] << ", " << mesh->lo()[2]
+				   << ") - (" << mesh->hi()[0] << ", " << mesh->hi()[1] << ", " << mesh->hi()[2] << ")"
+				   << std::endl;
+	amrex::Print() << " Read in " << read_time << " s" << std::endl;
+
+    // Build the STL implicit function, with the distance cut off a few fine cells away
+    const Real* dx = geom.back().CellSize();
+    const Real max_distance = 4.0 * std::max({dx[0], dx[1], dx[2]});
+    STLIF my_stl(mesh, inside, max_distance);
+
+    // Generate GeometryShop
+    auto gshop = EB2::makeShop(my_stl);
+
+    // Build index space
+    int max_level_here = 0;
+	int max_coarsening_level = 100;
+    start_time = ParallelDescriptor::second();
+	EB2::Build(gshop, geom.back(), max_level_here, max_level_here + max_coarsening_level);
+    Real build_time = ParallelDescriptor::second() - start_time;
+    ParallelDescriptor::ReduceRealMax(build_time, ParallelDescriptor::IOProcessorNumber());
+	amrex::Print() << " Built index space in " << build_time << " s" << std::endl;
+
+    // Make the EBFabFactory
+    MakeEBFactories();
+}
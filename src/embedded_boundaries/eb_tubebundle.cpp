@@ -0,0 +1,114 @@
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF_Cylinder.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include <eb_if.H>
+#include <incflo.H>
+
+/********************************************************************************
+ *                                                                              *
+ * Function to create a bundle of parallel cylinders (tubes) EB.                *
+ *                                                                              *
+ * The tubes are read from tubebundle.file, one per line: the coordinates of a  *
+ * point on the axis and the radius. With thousands of tubes, each point is     *
+ * only tested against the tubes next to it (SpatialListIF).                    *
+ *                                                                              *
+ ********************************************************************************/
+void incflo::make_eb_tubebundle()
+{
+    // Initialise tube bundle parameters
+    std::string tube_file;
+    int direction = 2;
+    bool inside = false;
+
+    // Get tube bundle information from inputs file.
+    ParmParse pp("tubebundle");
+
+    pp.get("file", tube_file);
+    pp.query("direction", direction);
+    pp.query("internal_flow", inside);
+
+    // Read the tubes (on all ranks)
+    Vector<char> chars;
+    ParallelDescriptor::ReadAndBcastFile(tube_file, chars);
+    std::istringstream is(std::string(chars.dataPtr()));
+
+    Vector<RealArray> centers;
+    Vector<Real> radii;
+    RealArray c;
+    Real r;
+    while(is >> c[0] >> c[1] >> c[2] >> r)
+    {
+        centers.push_back(c);
+        radii.push_back(r);
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!centers.empty(), "No tubes in tubebundle.file");
+
+    // Print info about tube bundle
+	amrex::Print() << " " << std::endl;
+	amrex::Print() << " Internal Flow: " << inside << std::endl;
+	amrex::Print() << " Direction:     " << direction << std::endl;
+	amrex::Print() << " Tubes:         " << centers.size() << std::endl;
+
+    // Each tube only matters up to delta from its wall. Along the axis, the boxes reach
+    // well beyond the domain, where EB2 also evaluates the implicit function.
+    const Geometry& fine_geom = geom.back();
+    const Real* dx = fine_geom.CellSize();
+    const Real delta = 2.0 * std::max({dx[0], dx[1], dx[2]});
+    const Real axis_len = fine_geom.ProbHi(direction) - fine_geom.ProbLo(direction);
+
+    Vector<EB2::CylinderIF> tubes;
+    Vector<RealArray> lo(centers.size()), hi(centers.size());
+
+    // A CylinderIF is +-(r^2 - d^2), which is at least 2 r delta + delta^2 away from 0 at a
+    // distance d >= r + delta from the axis
+    Real far_value = std::numeric_limits<Real>::max();
+
+    for(int i = 0; i < centers.size(); i++)
+    {
+        tubes.emplace_back(radii[i], direction, centers[i], inside);
+
+        for(int d = 0; d < 3; d++)
+        {
+            if(d == direction)
+            {
+                lo[i][d] = fine_geom.ProbLo(d) - 0.5 * axis_len;
+                hi[i][d] = fine_geom.ProbHi(d) + 0.5 * axis_len;
+            }
+            else
+            {
+                lo[i][d] = centers[i][d] - radii[i] - delta;
+                hi[i][d] = centers[i][d] + radii[i] + delta;
+            }
+        }
+
+        far_value = std::min(far_value, 2.0 * radii[i] * delta + delta * delta);
+    }
+
+    int max_level_here = 0;
+	int max_coarsening_level = 100;
+
+    // Flow around the tubes: the body is the union of the tubes. Flow inside the tubes: the
+    // body is the intersection of their outsides.
+    if(!inside)
+    {
+        SpatialUnionListIF<EB2::CylinderIF> my_tubes(tubes, lo, hi, -far_value);
+        auto gshop = EB2::makeShop(my_tubes);
+        EB2::Build(gshop, geom.back(), max_level_here, max_level_here + max_coarsening_level);
+    }
+    else
+    {
+        SpatialIntersectionListIF<EB2::CylinderIF> my_tubes(tubes, lo, hi, far_value);
+        auto gshop = EB2::makeShop(my_tubes);
+        EB2::Build(gshop, geom.back(), max_level_here, max_level_here + max_coarsening_level);
+    }
+
+    // Make the EBFabFactory
+    MakeEBFactories();
+}
@@ -10,7 +10,7 @@ void incflo::MakeEBGeometry()
 
 	/******************************************************************************
    * incflo.geometry=<string> specifies the EB geometry. <string> can be one of    *
-   * box, cylinder, annulus, sphere, spherecube, twocylinders
+   * box, cylinder, annulus, sphere, spherecube, twocylinders, stl, tubebundle
    ******************************************************************************/
 
 	ParmParse pp("incflo");
@@ -18,6 +18,19 @@ void incflo::MakeEBGeometry()
 	std::string geom_type;
 	pp.query("geometry", geom_type);
 
+    // Use the index space of an earlier run with the same geometry if there is one
+    std::string cache_key;
+    if(!eb_cache_dir.empty())
+    {
+        cache_key = EBCacheKey(geom_type);
+        if(ReadEBCache(cache_key))
+        {
+            MakeEBFactories();
+            amrex::Print() << "Done making the geometry ebfactory.\n" << std::endl;
+            return;
+        }
+    }
+
 	/******************************************************************************
    *                                                                            *
    *  CONSTRUCT EB                                                              *
@@ -54,15 +67,52 @@ void incflo::MakeEBGeometry()
 		amrex::Print() << "\n Building spherecube geometry." << std::endl;
         make_eb_spherecube();
 	}
+	else if(geom_type == "stl")
+	{
+		amrex::Print() << "\n Building STL geometry." << std::endl;
+        make_eb_stl();
+	}
+	else if(geom_type == "tubebundle")
+	{
+		amrex::Print() << "\n Building tubebundle geometry." << std::endl;
+        make_eb_tubebundle();
+	}
 	else
 	{
 		amrex::Print() << "\n No EB geometry declared in inputs => "
 					   << " Will read walls from incflo.dat only." << std::endl;
         make_eb_regular();
 	}
+
+    if(!eb_cache_dir.empty())
+    {
+        WriteEBCache(cache_key);
+    }
+
     amrex::Print() << "Done making the geometry ebfactory.\n" << std::endl;
 }
 
+// Make the EBFabFactory of each level from the current index space
+void incflo::MakeEBFactories()
+{
+    const EB2::IndexSpace& eb_is = EB2::IndexSpace::top();
+    EBSupport m_eb_support_level = EBSupport::full;
+
+    for(int lev = 0; lev <= max_level; lev++)
+    {
+        const EB2::Level& eb_is_lev = eb_is.getLevel(geom[lev]);
+        eb_level = &eb_is_lev;
+        ebfactory[lev].reset(new EBFArrayBoxFactory(*eb_level, 
+                                                    geom[lev], 
+                                                    grids[lev], 
+                                                    dmap[lev],
+                                                    {m_eb_basic_grow_cells, 
+                                                    m_eb_volume_grow_cells, 
+                                                    m_eb_full_grow_cells},
+                                                    m_eb_support_level));
+    }
+}
+
 // This function checks if ebfactory is allocated with
 // the proper dm and ba
 bool incflo::UpdateEBFactory(int a_lev)
@@ -105,5 +155,56 @@ bool incflo::UpdateEBFactory(int a_lev)
         }
     }
 
+    // The scratch buffers refer to the old factory
+    if(is_updated) scratch.clear();
+
     return is_updated;
 }
+
+// EB type of the tiles of level lev, (re)built when the grids or the tile size have changed
+const EBTiles& incflo::GetEBTiles(int lev)
+{
+    if(!eb_tiles[lev] || !eb_tiles[lev]->compatible(grids[lev], dmap[lev]))
+    {
+        AMREX_ALWAYS_ASSERT(ebfactory[lev]->boxArray() == grids[lev] &&
+                            ebfactory[lev]->DistributionMap() == dmap[lev]);
+        eb_tiles[lev].reset(new EBTiles(*ebfactory[lev], nghost));
+    }
+    return *eb_tiles[lev];
+}
+
+// Remove the boxes of the level 0 grids which are covered by the EB, with a margin of nghost
+// cells: the stencils of the fluid cells, and the ghost cells they use, then never reach into
+// the holes. Nothing reads or fills the data there.
+void incflo::RemoveCoveredGrids(BoxArray& ba) const
+{
+    BL_PROFILE("incflo::RemoveCoveredGrids()");
+
+    const EB2::Level& eb_level_0 = EB2::IndexSpace::top().getLevel(geom[0]);
+    DistributionMapping dm(ba);
+    EBFArrayBoxFactory factory(eb_level_0, geom[0], ba, dm, {nghost, nghost, nghost}, EBSupport::basic);
+    const auto& flags = factory.getMultiEBCellFlagFab();
+
+    Vector<int> covered(ba.size(), 0);
+    for(MFIter mfi(flags); mfi.isValid(); ++mfi)
+    {
+        if(flags[mfi].getType(amrex::grow(mfi.validbox(), nghost)) == FabType::covered)
+        {
+            covered[mfi.index()] = 1;
+        }
+    }
+    ParallelDescriptor::ReduceIntMax(covered.dataPtr(), covered.size());
+
+    BoxList bl;
+    for(int i = 0; i < ba.size(); i++)
+    {
+        if(!covered[i]) bl.push_back(ba[i]);
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!bl.isEmpty(), "All grids are covered by the EB");
+
+    amrex::Print() << "Removed " << ba.size() - bl.size() << " of " << ba.size()
+                   << " grids covered by the EB" << std::endl;
+
+    ba = BoxArray(bl);
+}
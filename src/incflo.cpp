@@ -84,6 +84,17 @@ BoxArray incflo::MakeBaseGrids () const
         ChopGrids(geom[0].Domain(), ba, ParallelDescriptor::NProcs());
     }
 
+    // Boxes inside the EB hold no fluid. Chop the rest again if that leaves too few.
+    if ( remove_covered_grids ) {
+        RemoveCoveredGrids(ba);
+
+        if ( refine_grid_layout &&
+             ba.size() < ParallelDescriptor::NProcs() ){
+            ChopGrids(geom[0].Domain(), ba, ParallelDescriptor::NProcs());
+            RemoveCoveredGrids(ba);
+        }
+    }
+
     if (ba == grids[0]) {
         ba = grids[0];  // to avoid dupliates
     }
@@ -142,6 +153,8 @@ void incflo::Evolve()
 {
     BL_PROFILE("incflo::Evolve()");
 
+    Real strt_time = ParallelDescriptor::second();
+
     bool do_not_evolve = ((max_step == 0) || ((stop_time >= 0.) && (cur_time > stop_time)) ||
    					     ((stop_time <= 0.) && (max_step <= 0))) && !steady_state;
 
@@ -163,6 +176,12 @@ void incflo::Evolve()
         nstep++;
         cur_time += dt;
 
+        // Update running averages before any output so that checkpoints include this step
+        if(stats_start_time >= 0.0 && cur_time >= stats_start_time && (nstep % stats_int == 0))
+        {
+            AccumulateStatistics();
+        }
+
         // Write plot and checkpoint files
         if((plot_int > 0 && (nstep % plot_int == 0)) ||
            (plot_per > 0 && (std::abs(remainder(cur_time, plot_per)) < 1.e-12)))
@@ -176,6 +195,23 @@ void incflo::Evolve()
             WriteCheckPointFile();
             last_chk = nstep;
         }
+        if(stats_plot_int > 0 && (nstep % stats_plot_int == 0))
+        {
+            WriteStatisticsPlotFile();
+        }
+        if(sampler->sampleDue(nstep))
+        {
+            SampleFields();
+        }
+        if(force_monitor->due(nstep))
+        {
+            MonitorForces();
+        }
+
+        // Cells advanced in this step, for the cell updates per second in the timer report
+        long ncells = 0;
+        for(int lev = 0; lev <= finest_level; lev++) ncells += grids[lev].numPts();
+        PhaseTimer::endStep(nstep, cur_time, ncells);
 
         // Mechanism to terminate incflo normally.
         do_not_evolve = (steady_state && SteadyStateReached()) ||
@@ -184,12 +220,21 @@ void incflo::Evolve()
     }
 
 	// Output at the final time
+    sampler->flush();
+    force_monitor->flush();
     if(check_int > 0 && nstep != last_chk) WriteCheckPointFile();
     if((plot_int > 0 || plot_per > 0) && nstep != last_plt)
     {
         UpdateDerivedQuantities();
         WritePlotFile();
     }
+    if(stats_start_time >= 0.0 && !(stats_plot_int > 0 && nstep % stats_plot_int == 0))
+    {
+        WriteStatisticsPlotFile();
+    }
+
+    PhaseTimer::summary(ParallelDescriptor::second() - strt_time);
+    if(incflo_verbose > 0) scratch.printStatistics();
 }
 
 // tag cells for refinement
@@ -204,8 +249,7 @@ void incflo::ErrorEst(int lev,
     const char   tagval = TagBox::SET;
     const char clearval = TagBox::CLEAR;
 
-    auto const& factory = dynamic_cast<EBFArrayBoxFactory const&>(ro[lev]->Factory());
-    auto const& flags = factory.getMultiEBCellFlagFab();
+    const EBTiles& tiles = GetEBTiles(lev);
 
     const Real* dx      = geom[lev].CellSize();
     const Real* prob_lo = geom[lev].ProbLo();
@@ -213,12 +257,10 @@ void incflo::ErrorEst(int lev,
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-    for (MFIter mfi(*ro[lev],true); mfi.isValid(); ++mfi)
+    for (MFIter mfi(*ro[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
         const Box& bx  = mfi.tilebox();
-        const auto& flag = flags[mfi];
-        const FabType typ = flag.getType(bx);
-        if (typ != FabType::covered)
+        if (tiles.type(mfi, 0) != FabType::covered)
         {
             TagBox&     tagfab  = tags[mfi];
 
@@ -318,7 +360,6 @@ void incflo::AverageDownTo(int crse_lev)
     amrex::EB_average_down(*ro[crse_lev+1],         *ro[crse_lev],         0, 1, rr);
     amrex::EB_average_down(*eta[crse_lev+1],        *eta[crse_lev],        0, 1, rr);
     amrex::EB_average_down(*strainrate[crse_lev+1], *strainrate[crse_lev], 0, 1, rr);
-    amrex::EB_average_down(*vort[crse_lev+1],       *vort[crse_lev],       0, 1, rr);
     amrex::EB_average_down(*gp[crse_lev+1],         *gp[crse_lev],         0, AMREX_SPACEDIM, rr);
     amrex::EB_average_down(*vel[crse_lev+1],        *vel[crse_lev],        0, AMREX_SPACEDIM, rr);
 }
@@ -16,7 +16,8 @@ using namespace std;
 //
 // C = max(|U|)/dx + max(|V|)/dy + max(|W|)/dz    --> Convection
 //
-// V = 2 * max(eta/ro) * (1/dx^2 + 1/dy^2 +1/dz^2) --> Diffusion
+// V = 2 * max(eta/ro) * (1/dx^2 + 1/dy^2 +1/dz^2) --> Diffusion (0 with the implicit viscous
+//                                                      solve, unless a step is redone)
 //
 // Fx, Fy, Fz = net acceleration due to external forces
 //
@@ -25,6 +26,7 @@ using namespace std;
 void incflo::ComputeDt(int initialisation)
 {
 	BL_PROFILE("incflo::ComputeDt");
+	INCFLO_TIMER("ComputeDt");
 
 	// Compute dt for this time step
 	Real umax = 0.0;
@@ -51,8 +53,12 @@ void incflo::ComputeDt(int initialisation)
     // Convective term
     Real conv_cfl = std::max(std::max(umax * idx, vmax * idy), wmax * idz);
 
-    // Viscous term
-    Real diff_cfl = 2.0 * etamax / romin * (idx * idx + idy * idy + idz * idz);
+    // Viscous term (no constraint when it is fully implicit and the solve converges)
+    Real diff_cfl = 0.0;
+    if(viscous_dt_limit)
+    {
+        diff_cfl = 2.0 * etamax / romin * (idx * idx + idy * idy + idz * idz);
+    }
 
     // Forcing term
     Real forc_cfl = std::abs(gravity[0] - std::abs(gp0[0])) * idx
@@ -124,3 +130,124 @@ void incflo::ComputeDt(int initialisation)
 		dt = dt_new;
 	}
 }
+
+//
+// Local pseudo-time steps for steady_state runs with steady_state_lts = 1.
+//
+// Each cell takes the step given by the formula above with its own velocity, viscosity and
+// density and the cell size of its level, at the pseudo-time CFL number lts_cfl. We store the
+// ratio s = dtau / dt of this step to the global one, and advance
+//
+//      u^(n+1) = u^n + dt * s * ( conv + divtau + g - grad(p + p0) / ro )
+//
+// Multiplying the momentum equations by s > 0 does not change their steady state. The implicit
+// diffusion solve and the projection see the local step through the density ro / s (ro_lts),
+// which leaves p the physical pressure.
+//
+// lts_cfl is ramped by switched evolution relaxation, cfl * R_0 / R with R the residual
+// (ComputeResidual) of the last step and R_0 the largest one so far, bounded by lts_cfl_max
+// and by the growth factor lts_cfl_growth per step.
+//
+void incflo::ComputeLocalTimeStep()
+{
+	BL_PROFILE("incflo::ComputeLocalTimeStep");
+	INCFLO_TIMER("ComputeLocalTimeStep");
+
+    if(lts_cfl < 0.0)
+    {
+        lts_cfl = cfl;
+    }
+    else if(lts_residual > 0.0)
+    {
+        Real ser_cfl = cfl * lts_residual_0 / lts_residual;
+        lts_cfl = amrex::min(ser_cfl, lts_cfl_growth * lts_cfl);
+        lts_cfl = amrex::max(cfl, amrex::min(lts_cfl, lts_cfl_max));
+    }
+
+    const Real eps = std::numeric_limits<Real>::epsilon();
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        const Real* dx = geom[lev].CellSize();
+        const Real idx = 1.0 / dx[0];
+        const Real idy = 1.0 / dx[1];
+        const Real idz = 1.0 / dx[2];
+
+        const Real forc_cfl = std::abs(gravity[0] - std::abs(gp0[0])) * idx
+                            + std::abs(gravity[1] - std::abs(gp0[1])) * idy
+                            + std::abs(gravity[2] - std::abs(gp0[2])) * idz;
+
+        // The ghost cells of vel, ro and eta have been filled at the start of the step, so the
+        // ratio is computed on the grown boxes and needs no exchange
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*lts_ratio[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.growntilebox();
+
+            const EBFArrayBox& vel_fab = static_cast<EBFArrayBox const&>((*vel[lev])[mfi]);
+            const auto& flag_arr = vel_fab.getEBCellFlagFab().array();
+
+            const auto& vel_arr = vel[lev]->array(mfi);
+            const auto& ro_arr = ro[lev]->array(mfi);
+            const auto& eta_arr = eta[lev]->array(mfi);
+            const auto& ratio_arr = lts_ratio[lev]->array(mfi);
+            const auto& ro_lts_arr = ro_lts[lev]->array(mfi);
+
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                Real s = 1.0;
+                if(!flag_arr(i,j,k).isCovered())
+                {
+                    Real conv_cfl = std::max(std::max(std::abs(vel_arr(i,j,k,0)) * idx,
+                                                      std::abs(vel_arr(i,j,k,1)) * idy),
+                                                      std::abs(vel_arr(i,j,k,2)) * idz);
+                    Real diff_cfl = viscous_dt_limit ? 2.0 * eta_arr(i,j,k) / ro_arr(i,j,k)
+                                  * (idx * idx + idy * idy + idz * idz) : 0.0;
+                    Real comb_cfl = conv_cfl + diff_cfl
+                                  + sqrt(pow(conv_cfl + diff_cfl, 2) + 4.0 * forc_cfl);
+
+                    s = lts_max_ratio;
+                    if(comb_cfl > eps)
+                    {
+                        s = amrex::min(s, 2.0 * lts_cfl / (comb_cfl * dt));
+                    }
+                }
+                ratio_arr(i,j,k) = s;
+                ro_lts_arr(i,j,k) = ro_arr(i,j,k) / s;
+            }
+        }
+    }
+
+    lts_active = true;
+
+    if(incflo_verbose > 0)
+    {
+        amrex::Print() << "Local time stepping with pseudo-time CFL = " << lts_cfl << std::endl;
+    }
+}
+
+//
+// Density seen by the implicit diffusion solve and the projection: ro / s with local time
+// steps, ro otherwise
+//
+const Vector<std::unique_ptr<MultiFab>>& incflo::StepDensity() const
+{
+    return lts_active ? ro_lts : ro;
+}
+
+//
+// Multiply the explicit terms by the local time step ratio (no-op without local time steps)
+//
+void incflo::ScaleByLocalTimeStep(int lev, MultiFab& mf)
+{
+    if(!lts_active) return;
+
+    for(int n = 0; n < mf.nComp(); n++)
+    {
+        MultiFab::Multiply(mf, *lts_ratio[lev], 0, n, 1, 0);
+    }
+}
@@ -1,8 +1,5 @@
 #include <incflo.H>
 #include <AMReX_buildInfo.H>
-
-// TODO: find better way of making the fillpatch stuff work
-void set_ptr_to_incflo(incflo& my_incflo);
  
 void writeBuildInfo();
 
@@ -27,6 +27,7 @@
 void incflo::ApplyProjection(Real time, Real scaling_factor)
 {
 	BL_PROFILE("incflo::ApplyProjection");
+	INCFLO_TIMER("ApplyProjection");
 
     if(incflo_verbose > 2)
     {
@@ -34,6 +35,9 @@ void incflo::ApplyProjection(Real time, Real scaling_factor)
         PrintMaxValues(time);
     }
 
+    // Density of the momentum updates (divided by the local time step ratio for local time steps)
+    const Vector<std::unique_ptr<MultiFab>>& ro_step = StepDensity();
+
     // Add the ( grad p /ro ) back to u* (note the +dt)
     if(nstep >= 0)
     {
@@ -42,21 +46,23 @@ void incflo::ApplyProjection(Real time, Real scaling_factor)
             // Convert velocities to momenta
             for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
             {
-                MultiFab::Multiply(*vel[lev], *ro[lev], 0, dir, 1, vel[lev]->nGrow());
+                MultiFab::Multiply(*vel[lev], *ro_step[lev], 0, dir, 1, vel[lev]->nGrow());
             }
 
-            MultiFab::Saxpy(*vel[lev], scaling_factor, *gp[lev], 0, 0, AMREX_SPACEDIM, vel[lev]->nGrow());
+            // Only over the ghost layers of gp, the outer ones of vel are refilled before they
+            // are read (see ApplyPredictor)
+            MultiFab::Saxpy(*vel[lev], scaling_factor, *gp[lev], 0, 0, AMREX_SPACEDIM, gp[lev]->nGrow());
 
             // Convert momenta back to velocities
             for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
             {
-                MultiFab::Divide(*vel[lev], *ro[lev], 0, dir, 1, vel[lev]->nGrow());
+                MultiFab::Divide(*vel[lev], *ro_step[lev], 0, dir, 1, vel[lev]->nGrow());
             }
         }
     }
 
     // Make sure div(u) is up to date
-    ComputeDivU(time);
+    Vector<std::unique_ptr<MultiFab>> divu = ComputeDivU(time);
 
     // Declare, resize, reset and initialize MultiFabs to hold the solution of the Poisson solve
 	Vector<std::unique_ptr<MultiFab>> phi;
@@ -66,12 +72,10 @@ void incflo::ApplyProjection(Real time, Real scaling_factor)
     for(int lev = 0; lev <= finest_level; lev++)
     {
         const BoxArray & nd_grids = amrex::convert(grids[lev], IntVect{1,1,1});
-        phi[lev].reset(new MultiFab(nd_grids, dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
+        phi[lev] = scratch.acquire(nd_grids, dmap[lev], 1, ng_nodal, *ebfactory[lev]);
         phi[lev]->setVal(0.0);
-        fluxes[lev].reset(new MultiFab(vel[lev]->boxArray(),
-                                       vel[lev]->DistributionMap(),
-                                       vel[lev]->nComp(), 1,
-                                       MFInfo(), *ebfactory[lev]));
+        fluxes[lev] = scratch.acquire(vel[lev]->boxArray(), vel[lev]->DistributionMap(),
+                                      vel[lev]->nComp(), 1, *ebfactory[lev]);
         fluxes[lev]->setVal(1.0e200);
     }
 
@@ -86,7 +90,8 @@ void incflo::ApplyProjection(Real time, Real scaling_factor)
     //      
     // Also outputs minus grad(phi) / rho into "fluxes"
     //
-	poisson_equation->solve(phi, fluxes, ro, divu);
+	poisson_equation->solve(phi, fluxes, ro_step, divu);
+    scratch.release(divu);
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
@@ -97,7 +102,7 @@ void incflo::ApplyProjection(Real time, Real scaling_factor)
         fluxes[lev]->mult(-1.0 / scaling_factor, fluxes[lev]->nGrow());
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
         {
-            MultiFab::Multiply(*fluxes[lev], (*ro[lev]), 0, dir, 1, fluxes[lev]->nGrow());
+            MultiFab::Multiply(*fluxes[lev], (*ro_step[lev]), 0, dir, 1, fluxes[lev]->nGrow());
         }
 
         // phi currently holds dt * phi so we divide by dt 
@@ -115,6 +120,9 @@ void incflo::ApplyProjection(Real time, Real scaling_factor)
             MultiFab::Add(*p[lev], *phi[lev], 0, 0, 1, phi[lev]->nGrow());
             MultiFab::Add(*gp[lev], *fluxes[lev], 0, 0, AMREX_SPACEDIM, fluxes[lev]->nGrow());
         }
+
+        scratch.release(std::move(phi[lev]));
+        scratch.release(std::move(fluxes[lev]));
     }
 
     AverageDown();
@@ -6,6 +6,7 @@
 void incflo::ComputeViscosity()
 {
 	BL_PROFILE("incflo::ComputeViscosity");
+	INCFLO_TIMER("ComputeViscosity");
 
     for(int lev = 0; lev <= finest_level; lev++)
     {
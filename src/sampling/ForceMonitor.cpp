@@ -0,0 +1,219 @@
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <ForceMonitor.H>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+using namespace amrex;
+
+ForceMonitor::ForceMonitor(bool output)
+{
+    // Get inputs from ParmParse
+    readParameters();
+    if(!output) force_int = -1;
+
+    if(active() && ParallelDescriptor::IOProcessor())
+    {
+        if(!amrex::UtilCreateDirectory(output_dir, 0755))
+        {
+            amrex::CreateDirectoryFailed(output_dir);
+        }
+    }
+}
+
+ForceMonitor::~ForceMonitor()
+{
+    flush();
+}
+
+void ForceMonitor::readParameters()
+{
+    ParmParse pp("forces");
+
+    pp.query("verbose", verbose);
+    pp.query("int", force_int);
+    pp.query("flush_int", flush_int);
+    pp.query("output_dir", output_dir);
+
+    const Real huge = std::numeric_limits<Real>::max();
+
+    Vector<std::string> names;
+    pp.queryarr("bodies", names);
+
+    if(names.empty())
+    {
+        Body body;
+        body.name = "body";
+        body.lo = {-huge, -huge, -huge};
+        body.hi = { huge,  huge,  huge};
+
+        Vector<Real> c(3, 0.0);
+        pp.queryarr("center", c, 0, 3);
+        body.center = {c[0], c[1], c[2]};
+
+        bodies.push_back(body);
+    }
+
+    for(const std::string& name : names)
+    {
+        ParmParse ppb("forces." + name);
+
+        Body body;
+        body.name = name;
+
+        Vector<Real> lo(3, -huge), hi(3, huge), c(3, 0.0);
+        ppb.queryarr("lo", lo, 0, 3);
+        ppb.queryarr("hi", hi, 0, 3);
+        ppb.queryarr("center", c, 0, 3);
+
+        body.lo = {lo[0], lo[1], lo[2]};
+        body.hi = {hi[0], hi[1], hi[2]};
+        body.center = {c[0], c[1], c[2]};
+
+        bodies.push_back(body);
+    }
+}
+
+void ForceMonitor::record(Real time, const Vector<Real>& values)
+{
+    AMREX_ASSERT(values.size() == nvalues * bodies.size());
+
+    if(ParallelDescriptor::IOProcessor())
+    {
+        for(int b = 0; b < bodies.size(); b++)
+        {
+            Vector<Real>& buffer = bodies[b].buffer;
+            buffer.push_back(time);
+            buffer.insert(buffer.end(), &values[nvalues * b], &values[0] + nvalues * (b + 1));
+        }
+    }
+
+    if(verbose > 0)
+    {
+        for(int b = 0; b < bodies.size(); b++)
+        {
+            const Real* v = &values[nvalues * b];
+            amrex::Print() << "Force on " << bodies[b].name << " = ("
+                           << v[0] + v[3] << ", " << v[1] + v[4] << ", " << v[2] + v[5]
+                           << "), torque = ("
+                           << v[6] + v[9] << ", " << v[7] + v[10] << ", " << v[8] + v[11]
+                           << ")" << std::endl;
+        }
+    }
+
+    nbuffered++;
+    if(flush_int > 0 && nbuffered >= flush_int)
+    {
+        flush();
+    }
+}
+
+//
+// Append all buffered records to the body files
+//
+void ForceMonitor::flush()
+{
+    if(nbuffered == 0) return;
+
+	BL_PROFILE("ForceMonitor::flush");
+
+    if(ParallelDescriptor::IOProcessor())
+    {
+        for(Body& body : bodies)
+        {
+            // After a restart, the records are appended to the existing file
+            std::string FileName(output_dir + "/" + body.name + ".dat");
+            const bool new_file = !amrex::FileExists(FileName);
+
+            std::ofstream File(FileName.c_str(), std::ofstream::out | std::ofstream::app);
+            if(!File.good())
+                amrex::FileOpenFailed(FileName);
+
+            if(new_file)
+            {
+                File << "# time Fpx Fpy Fpz Fvx Fvy Fvz Tpx Tpy Tpz Tvx Tvy Tvz\n";
+            }
+
+            File.precision(12);
+            File << std::scientific;
+            for(int r = 0; r < body.buffer.size(); r += nvalues + 1)
+            {
+                for(int n = 0; n <= nvalues; n++)
+                {
+                    File << body.buffer[r + n] << (n < nvalues ? ' ' : '\n');
+                }
+            }
+            File.close();
+
+            body.buffer.clear();
+        }
+    }
+
+    if(verbose > 0)
+    {
+        amrex::Print() << "ForceMonitor: wrote " << nbuffered << " records to " << output_dir << std::endl;
+    }
+
+    nbuffered = 0;
+}
+
+//
+// Keep the header and the records up to time in the body files
+//
+void ForceMonitor::restart(Real time)
+{
+    if(!active()) return;
+
+    // Times are written with 12 digits
+    const Real time_max = time + 1.e-10 * std::max(Real(1.0), std::abs(time));
+
+    if(ParallelDescriptor::IOProcessor())
+    {
+        for(const Body& body : bodies)
+        {
+            std::string FileName(output_dir + "/" + body.name + ".dat");
+            if(!amrex::FileExists(FileName)) continue;
+
+            Vector<std::string> lines;
+            int ndropped = 0;
+            {
+                std::ifstream File(FileName.c_str());
+                std::string line;
+                while(std::getline(File, line))
+                {
+                    Real t = 0.0;
+                    std::istringstream is(line);
+                    if(line.empty() || line[0] == '#' || !(is >> t) || t <= time_max)
+                    {
+                        lines.push_back(line);
+                    }
+                    else
+                    {
+                        ndropped++;
+                    }
+                }
+            }
+
+            if(ndropped == 0) continue;
+
+            std::ofstream File(FileName.c_str(), std::ofstream::out | std::ofstream::trunc);
+            if(!File.good())
+                amrex::FileOpenFailed(FileName);
+            for(const std::string& line : lines) File << line << '\n';
+            File.close();
+
+            if(verbose > 0)
+            {
+                amrex::Print() << "ForceMonitor: dropped " << ndropped << " records after t = "
+                               << time << " from " << FileName << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,467 @@
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <Sampler.H>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+using namespace amrex;
+
+namespace
+{
+    // Names of the fields, in the order of Sampler::Field
+    const std::string field_names[] = {"velx", "vely", "velz", "p", "eta", "vort"};
+
+    //
+    // Cell iv containing the point x, and the lower-left points and weights of the
+    // cell-centred (icc, wcc) and nodal (ind, wnd) interpolation stencils. Points on the upper
+    // domain face belong to the last cell.
+    //
+    void find_stencil(const RealArray& x, const Geometry& geom,
+                      IntVect& iv, IntVect& icc, Real* wcc, IntVect& ind, Real* wnd)
+    {
+        const Box& domain = geom.Domain();
+        for(int d = 0; d < AMREX_SPACEDIM; d++)
+        {
+            Real xi = (x[d] - geom.ProbLo(d)) * geom.InvCellSize(d);
+            iv[d] = static_cast<int>(std::floor(xi));
+            if(iv[d] == domain.bigEnd(d) + 1 && x[d] <= geom.ProbHi(d))
+            {
+                iv[d] = domain.bigEnd(d);
+            }
+            icc[d] = static_cast<int>(std::floor(xi - 0.5));
+            ind[d] = iv[d];
+            wcc[d] = xi - 0.5 - icc[d];
+            wnd[d] = xi - ind[d];
+        }
+    }
+
+    //
+    // True if every cell of the stencil box sbx is a valid cell of ba, the periodic image of
+    // one, or a ghost cell outside a non-periodic domain face (which the physical BCs fill
+    // from the valid cells next to it). Such stencils don't read coarse-fine ghost cells.
+    //
+    bool stencil_on_level(const BoxArray& ba, const Geometry& geom, Box sbx)
+    {
+        const Box& domain = geom.Domain();
+        for(int d = 0; d < AMREX_SPACEDIM; d++)
+        {
+            if(!geom.isPeriodic(d))
+            {
+                sbx.setSmall(d, std::max(sbx.smallEnd(d), domain.smallEnd(d)));
+                sbx.setBig(d, std::min(sbx.bigEnd(d), domain.bigEnd(d)));
+            }
+        }
+
+        if(!ba.contains(sbx & domain)) return false;
+
+        Vector<IntVect> pshifts;
+        geom.periodicShift(domain, sbx, pshifts);
+        for(const IntVect& shift : pshifts)
+        {
+            if(!ba.contains((sbx + shift) & domain)) return false;
+        }
+        return true;
+    }
+
+    //
+    // Trilinear interpolation of component n of cell-centred data to the point with
+    // lower-left stencil cell ilo and weights w. Covered cells are left out of the
+    // stencil and the remaining weights are renormalised.
+    //
+    template <class A, class F>
+    Real interpolate_cc(const A& arr, const F& flag, int n, const IntVect& ilo, const Real* w)
+    {
+        Real sum = 0.0;
+        Real wsum = 0.0;
+        for(int kk = 0; kk < 2; kk++)
+        for(int jj = 0; jj < 2; jj++)
+        for(int ii = 0; ii < 2; ii++)
+        {
+            const int i = ilo[0] + ii;
+            const int j = ilo[1] + jj;
+            const int k = ilo[2] + kk;
+
+            if(flag(i,j,k).isCovered()) continue;
+
+            Real wt = (ii ? w[0] : 1.0 - w[0])
+                    * (jj ? w[1] : 1.0 - w[1])
+                    * (kk ? w[2] : 1.0 - w[2]);
+            sum  += wt * arr(i,j,k,n);
+            wsum += wt;
+        }
+        return (wsum > 0.0) ? sum / wsum : 0.0;
+    }
+
+    //
+    // Trilinear interpolation of the sum of two nodal arrays
+    //
+    template <class A>
+    Real interpolate_nd(const A& a, const A& b, const IntVect& ilo, const Real* w)
+    {
+        Real sum = 0.0;
+        for(int kk = 0; kk < 2; kk++)
+        for(int jj = 0; jj < 2; jj++)
+        for(int ii = 0; ii < 2; ii++)
+        {
+            const int i = ilo[0] + ii;
+            const int j = ilo[1] + jj;
+            const int k = ilo[2] + kk;
+
+            Real wt = (ii ? w[0] : 1.0 - w[0])
+                    * (jj ? w[1] : 1.0 - w[1])
+                    * (kk ? w[2] : 1.0 - w[2]);
+            sum += wt * (a(i,j,k) + b(i,j,k));
+        }
+        return sum;
+    }
+}
+
+//
+// Constructor:
+// Probe locations don't change during the run, so they are all computed here
+//
+Sampler::Sampler(AmrCore* _amrcore,
+                 Vector<std::unique_ptr<EBFArrayBoxFactory>>* _ebfactory,
+                 bool output)
+{
+    amrcore = _amrcore;
+    ebfactory = _ebfactory;
+
+    // Get inputs from ParmParse
+    readParameters();
+    if(!output) sample_int = -1;
+
+    if(active() && ParallelDescriptor::IOProcessor())
+    {
+        if(!amrex::UtilCreateDirectory(output_dir, 0755))
+        {
+            amrex::CreateDirectoryFailed(output_dir);
+        }
+    }
+}
+
+Sampler::~Sampler()
+{
+    flush();
+}
+
+void Sampler::readParameters()
+{
+    ParmParse pp("sampling");
+
+    pp.query("verbose", verbose);
+    pp.query("int", sample_int);
+    pp.query("flush_int", flush_int);
+    pp.query("output_dir", output_dir);
+
+    Vector<std::string> fields_in;
+    pp.queryarr("fields", fields_in);
+    for(int f = 0; f < NumFields; f++)
+    {
+        if(fields_in.empty() || std::find(fields_in.begin(), fields_in.end(), field_names[f]) != fields_in.end())
+        {
+            fields.push_back(f);
+        }
+    }
+    for(const std::string& name : fields_in)
+    {
+        if(std::find(std::begin(field_names), std::end(field_names), name) == std::end(field_names))
+        {
+            amrex::Abort("Unknown sampling field " + name + "! Choose from velx vely velz p eta vort");
+        }
+    }
+
+    Vector<std::string> names;
+    pp.queryarr("probes", names);
+
+    for(const std::string& name : names)
+    {
+        ParmParse ppp("sampling." + name);
+
+        Probe probe;
+        probe.name = name;
+        ppp.get("type", probe.type);
+
+        if(probe.type == "point")
+        {
+            Vector<Real> loc(3);
+            ppp.getarr("location", loc, 0, 3);
+            probe.points.push_back({loc[0], loc[1], loc[2]});
+        }
+        else if(probe.type == "line")
+        {
+            Vector<Real> start(3), end(3);
+            int npts = 2;
+            ppp.getarr("start", start, 0, 3);
+            ppp.getarr("end", end, 0, 3);
+            ppp.query("num_points", npts);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(npts >= 2, "Line probes need at least 2 points");
+
+            for(int n = 0; n < npts; n++)
+            {
+                Real s = Real(n) / Real(npts - 1);
+                probe.points.push_back({start[0] + s * (end[0] - start[0]),
+                                        start[1] + s * (end[1] - start[1]),
+                                        start[2] + s * (end[2] - start[2])});
+            }
+        }
+        else if(probe.type == "plane")
+        {
+            // The plane lies at lo[normal]; the other two directions span [lo, hi]
+            Vector<Real> lo(3), hi(3);
+            Vector<int> npts(2, 2);
+            int normal = 2;
+            ppp.get("normal", normal);
+            ppp.getarr("lo", lo, 0, 3);
+            ppp.getarr("hi", hi, 0, 3);
+            ppp.queryarr("num_points", npts, 0, 2);
+            AMREX_ALWAYS_ASSERT(normal >= 0 && normal < 3);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(npts[0] >= 2 && npts[1] >= 2,
+                                             "Plane probes need at least 2 points per direction");
+
+            const int d0 = (normal + 1) % 3;
+            const int d1 = (normal + 2) % 3;
+            for(int n1 = 0; n1 < npts[1]; n1++)
+            for(int n0 = 0; n0 < npts[0]; n0++)
+            {
+                RealArray x = {lo[0], lo[1], lo[2]};
+                x[d0] = lo[d0] + Real(n0) / Real(npts[0] - 1) * (hi[d0] - lo[d0]);
+                x[d1] = lo[d1] + Real(n1) / Real(npts[1] - 1) * (hi[d1] - lo[d1]);
+                probe.points.push_back(x);
+            }
+        }
+        else
+        {
+            amrex::Abort("Unknown sampling probe type! Choose either point, line or plane");
+        }
+
+        amrex::Print() << "Sampling probe " << name << " (" << probe.type << ") with "
+                       << probe.points.size() << " points" << std::endl;
+
+        probes.push_back(std::move(probe));
+    }
+}
+
+bool Sampler::samplesViscosity() const
+{
+    return std::find(fields.begin(), fields.end(), static_cast<int>(visc)) != fields.end();
+}
+
+bool Sampler::samplesVorticity() const
+{
+    return std::find(fields.begin(), fields.end(), static_cast<int>(vorticity)) != fields.end();
+}
+
+//
+// Each point is sampled on the finest level whose grids contain it and, on the finer levels,
+// its whole interpolation stencil. The points are sorted by the box that holds them, so that
+// sampling only visits the points of the local boxes.
+//
+void Sampler::locatePoints()
+{
+	BL_PROFILE("Sampler::locatePoints");
+
+    const int finest_level = amrcore->finestLevel();
+
+    located_grids.resize(finest_level + 1);
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        located_grids[lev] = amrcore->boxArray(lev);
+    }
+
+    for(Probe& probe : probes)
+    {
+        const int npts = probe.points.size();
+        probe.box_points.assign(finest_level + 1, std::map<int, Vector<int>>());
+
+        for(int n = 0; n < npts; n++)
+        {
+            for(int lev = finest_level; lev >= 0; lev--)
+            {
+                const Geometry& geom = amrcore->Geom(lev);
+
+                IntVect iv, icc, ind;
+                Real wcc[AMREX_SPACEDIM], wnd[AMREX_SPACEDIM];
+                find_stencil(probe.points[n], geom, iv, icc, wcc, ind, wnd);
+
+                // Outside the domain on all levels
+                if(!geom.Domain().contains(iv)) break;
+
+                const auto isects = located_grids[lev].intersections(Box(iv, iv));
+                if(isects.empty()) continue;
+
+                if(lev > 0 && !stencil_on_level(located_grids[lev], geom,
+                                                Box(icc, icc + IntVect::TheUnitVector())))
+                {
+                    continue;
+                }
+
+                probe.box_points[lev][isects[0].first].push_back(n);
+                break;
+            }
+        }
+    }
+}
+
+//
+// Interpolate the sampled fields to all sample points. Each point is sampled by the rank
+// owning its box; the results are then summed onto the IO processor.
+//
+void Sampler::sample(Real time,
+                     const Vector<std::unique_ptr<MultiFab>>& vel,
+                     const Vector<std::unique_ptr<MultiFab>>& p,
+                     const Vector<std::unique_ptr<MultiFab>>& p0,
+                     const Vector<std::unique_ptr<MultiFab>>& eta,
+                     const Vector<std::unique_ptr<MultiFab>>& vort)
+{
+	BL_PROFILE("Sampler::sample");
+
+    const int finest_level = amrcore->finestLevel();
+
+    bool grids_changed = (located_grids.size() != finest_level + 1);
+    for(int lev = 0; lev <= finest_level && !grids_changed; lev++)
+    {
+        grids_changed = (located_grids[lev] != amrcore->boxArray(lev));
+    }
+    if(grids_changed) locatePoints();
+
+    const int nfields = fields.size();
+
+    for(Probe& probe : probes)
+    {
+        const int npts = probe.points.size();
+        Vector<Real> data(npts * nfields, 0.0);
+
+        for(int lev = 0; lev <= finest_level; lev++)
+        {
+            const Geometry& geom = amrcore->Geom(lev);
+            const auto& flags = (*ebfactory)[lev]->getMultiEBCellFlagFab();
+
+            for(MFIter mfi(*vel[lev], false); mfi.isValid(); ++mfi)
+            {
+                const auto it = probe.box_points[lev].find(mfi.index());
+                if(it == probe.box_points[lev].end()) continue;
+
+                const auto& vel_arr  =  vel[lev]->array(mfi);
+                const auto& p_arr    =    p[lev]->array(mfi);
+                const auto& p0_arr   =   p0[lev]->array(mfi);
+                const auto& flag_arr = flags[mfi].array();
+
+                for(int n : it->second)
+                {
+                    IntVect iv, icc, ind;
+                    Real wcc[AMREX_SPACEDIM], wnd[AMREX_SPACEDIM];
+                    find_stencil(probe.points[n], geom, iv, icc, wcc, ind, wnd);
+
+                    Real* vals = &data[n * nfields];
+                    for(int f = 0; f < nfields; f++)
+                    {
+                        switch(fields[f])
+                        {
+                            case velx:
+                            case vely:
+                            case velz:
+                                vals[f] = interpolate_cc(vel_arr, flag_arr, fields[f], icc, wcc);
+                                break;
+                            case pres:
+                                vals[f] = interpolate_nd(p_arr, p0_arr, ind, wnd);
+                                break;
+                            case visc:
+                                vals[f] = interpolate_cc(eta[lev]->array(mfi), flag_arr, 0, icc, wcc);
+                                break;
+                            case vorticity:
+                                vals[f] = interpolate_cc(vort[lev]->array(mfi), flag_arr, 0, icc, wcc);
+                                break;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Each point was sampled by exactly one rank
+        ParallelDescriptor::ReduceRealSum(data.dataPtr(), data.size(),
+                                          ParallelDescriptor::IOProcessorNumber());
+
+        if(ParallelDescriptor::IOProcessor())
+        {
+            probe.buffer.push_back(time);
+            probe.buffer.insert(probe.buffer.end(), data.begin(), data.end());
+        }
+    }
+
+    nbuffered++;
+    if(flush_int > 0 && nbuffered >= flush_int)
+    {
+        flush();
+    }
+}
+
+//
+// Append all buffered records to the probe files
+//
+void Sampler::flush()
+{
+    if(nbuffered == 0) return;
+
+	BL_PROFILE("Sampler::flush");
+
+    if(ParallelDescriptor::IOProcessor())
+    {
+        for(Probe& probe : probes)
+        {
+            if(!probe.header_written) writeProbeHeader(probe);
+
+            std::string FileName(output_dir + "/" + probe.name + ".bin");
+            std::ofstream File(FileName.c_str(),
+                               std::ofstream::out | std::ofstream::app | std::ofstream::binary);
+            if(!File.good())
+                amrex::FileOpenFailed(FileName);
+
+            File.write(reinterpret_cast<const char*>(probe.buffer.dataPtr()),
+                       probe.buffer.size() * sizeof(Real));
+            File.close();
+
+            probe.buffer.clear();
+        }
+    }
+
+    if(verbose > 0)
+    {
+        amrex::Print() << "Sampler: wrote " << nbuffered << " samples to " << output_dir << std::endl;
+    }
+
+    nbuffered = 0;
+}
+
+void Sampler::writeProbeHeader(Probe& probe) const
+{
+    std::string HeaderFileName(output_dir + "/" + probe.name + ".hdr");
+    std::ofstream HeaderFile(HeaderFileName.c_str(), std::ofstream::out | std::ofstream::trunc);
+    if(!HeaderFile.good())
+        amrex::FileOpenFailed(HeaderFileName);
+
+    HeaderFile.precision(17);
+
+    HeaderFile << "type: " << probe.type << "\n";
+    HeaderFile << "bytes_per_value: " << sizeof(Real) << "\n";
+    HeaderFile << "num_points: " << probe.points.size() << "\n";
+    HeaderFile << "num_fields: " << fields.size() << "\n";
+    HeaderFile << "fields:";
+    for(int f : fields)
+    {
+        HeaderFile << ' ' << field_names[f];
+    }
+    HeaderFile << "\n";
+    HeaderFile << "record: time, then num_fields values for each point\n";
+    HeaderFile << "points:\n";
+    for(const RealArray& x : probe.points)
+    {
+        HeaderFile << x[0] << ' ' << x[1] << ' ' << x[2] << '\n';
+    }
+
+    probe.header_written = true;
+}
@@ -0,0 +1,63 @@
+#include <incflo.H>
+
+//
+// Take an in-situ sample of the flow field at all probes defined in the inputs file
+//
+void incflo::SampleFields()
+{
+    BL_PROFILE("incflo::SampleFields()");
+    INCFLO_TIMER("SampleFields");
+
+    // The viscosity only depends on the velocity for non-Newtonian fluids, and the vorticity
+    // is only computed when it is sampled
+    if(sampler->samplesViscosity() && !constant_viscosity)
+    {
+        UpdateDerivedQuantities();
+    }
+
+    Vector<std::unique_ptr<MultiFab>> vort;
+    if(sampler->samplesVorticity())
+    {
+        vort = ComputeVorticity();
+    }
+
+    // The interpolation stencils reach one cell into the ghost region. The sampler keeps
+    // them off the coarse-fine ghost cells, all others are filled here: FillPatchVel for
+    // the velocity, the physical BCs and ghost cell exchanges for the other fields.
+    Vector<std::unique_ptr<MultiFab>> vel_fill(finest_level + 1);
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        vel_fill[lev] = scratch.acquire(grids[lev], dmap[lev], vel[lev]->nComp(), nghost,
+                                        *ebfactory[lev]);
+        FillPatchVel(lev, cur_time, *vel_fill[lev], 0, vel_fill[lev]->nComp());
+
+        if(!vort.empty())
+        {
+            vort[lev]->FillBoundary(geom[lev].periodicity());
+            GetBCList(lev).applyScalar(*vort[lev]);
+        }
+    }
+    FillScalarBC();
+
+    sampler->sample(cur_time, vel_fill, p, p0, eta, vort);
+
+    scratch.release(vel_fill);
+    scratch.release(vort);
+}
+
+//
+// Record the forces and torques on the EB bodies defined in the inputs file
+//
+void incflo::MonitorForces()
+{
+    BL_PROFILE("incflo::MonitorForces()");
+    INCFLO_TIMER("MonitorForces");
+
+    // The wall gradient of the velocity reaches into the ghost cells
+    FillVelocityBC(cur_time, 0);
+
+    Vector<Real> values;
+    ComputeForces(values);
+
+    force_monitor->record(cur_time, values);
+}
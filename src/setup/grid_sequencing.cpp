@@ -0,0 +1,313 @@
+#include <incflo.H>
+
+#include <cmath>
+#include <string>
+
+//
+// Grid sequencing for steady_state runs (incflo.grid_sequencing = N > 0).
+//
+// Before the run starts from the initial conditions, the steady state is solved on the level 0
+// domain coarsened by 2^N, then by 2^(N-1), ..., 2. Each stage starts from the solution of the
+// previous one, prolonged to its grids, and runs until SteadyStateReached() (or for at most
+// incflo.grid_sequencing_max_step steps). The run itself starts from the solution of the last
+// stage, so most of the transient is done on cheap grids.
+//
+// The stages are separate incflo objects with a single level. They use the coarse levels of
+// the EB index space built for the run (the same ones the multigrid solvers coarsen to), so the
+// domain of each stage must be coarsenable by 2^N and divisible by amr.blocking_factor, and
+// EB2 must have coarsened the geometry at least N times.
+// Plot, checkpoint, statistics, sampling and force output is off for the stages.
+//
+
+// Number of cells of the level 0 domain of fine coarsened by 2^coarsening
+Vector<int> incflo::CoarsenedCells(const incflo& fine, int coarsening)
+{
+    const Box& domain = fine.Geom(0).Domain();
+    const int ratio = 1 << coarsening;
+
+    Vector<int> n_cell(AMREX_SPACEDIM);
+    for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(domain.length(dir) % ratio == 0,
+                "Grid sequencing: the domain can't be coarsened by 2^incflo.grid_sequencing");
+        n_cell[dir] = domain.length(dir) / ratio;
+    }
+
+    // EB2 stops coarsening the index space where the geometry can't be represented any more
+    const Box& coarsest = EB2::IndexSpace::top().coarsestDomain();
+    for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
+    {
+        if(coarsest.length(dir) > n_cell[dir])
+        {
+            amrex::Abort("Grid sequencing: the EB geometry can only be coarsened to "
+                         + std::to_string(coarsest.length(dir)) + " cells in direction "
+                         + std::to_string(dir) + ", not " + std::to_string(n_cell[dir])
+                         + ". Reduce incflo.grid_sequencing.");
+        }
+    }
+
+    return n_cell;
+}
+
+incflo::incflo(const incflo& fine, int coarsening)
+    : AmrCore(&fine.Geom(0).ProbDomain(), 0, CoarsenedCells(fine, coarsening), fine.Geom(0).Coord())
+{
+    ReadParameters();
+
+    // A stage only produces the initial conditions of the next one
+    restart_file = "";
+    plot_int = -1;
+    plot_per = -1.0;
+    check_int = -1;
+    stats_start_time = -1.0;
+    grid_sequencing = 0;
+    max_step = fine.grid_sequencing_max_step;
+    is_stage = true;
+
+    ResizeArrays();
+
+    // The EB index space of fine (the top one) has the coarsened levels
+    MakeBCArrays();
+}
+
+//
+// Solve the stages of grid sequencing, from the coarsest to the finest, and return the last one
+//
+std::unique_ptr<incflo> incflo::SolveCoarseStages()
+{
+    BL_PROFILE("incflo::SolveCoarseStages()");
+
+    std::unique_ptr<incflo> stage;
+
+    for(int coarsening = grid_sequencing; coarsening >= 1; coarsening--)
+    {
+        std::unique_ptr<incflo> next(new incflo(*this, coarsening));
+
+        amrex::Print() << "\nGrid sequencing: solving the steady state on "
+                       << next->Geom(0).Domain().size() << " cells" << std::endl;
+
+        // The BCs of the fillpatch routines are those of the object being solved
+        set_ptr_to_incflo(*next);
+
+        next->GetInputBCs();
+        next->coarse_stage = stage.get();
+        next->InitData();
+        next->coarse_stage = nullptr;
+        next->SolveSteadyStage();
+
+        // The previous stage is not needed anymore
+        stage = std::move(next);
+    }
+
+    set_ptr_to_incflo(*this);
+
+    return stage;
+}
+
+//
+// Advance a stage of grid sequencing until the steady state is reached or max_step
+//
+void incflo::SolveSteadyStage()
+{
+    BL_PROFILE("incflo::SolveSteadyStage()");
+
+    bool reached = false;
+    while(!reached && nstep < max_step)
+    {
+        Advance();
+        nstep++;
+        cur_time += dt;
+
+        reached = SteadyStateReached();
+    }
+
+    if(reached)
+    {
+        amrex::Print() << "Grid sequencing: steady state reached after " << nstep
+                       << " steps" << std::endl;
+    }
+    else
+    {
+        amrex::Print() << "Grid sequencing: steady state not reached in " << max_step
+                       << " steps, continuing on the finer grids" << std::endl;
+    }
+
+    FillVelocityBC(cur_time, 0);
+}
+
+//
+// Fill the velocity of all levels by interpolation from level 0 of coarse.
+//
+// The interpolation is linear, with limited slopes (as cell_cons_interp) which leave out the
+// covered coarse cells and those outside the domain, so that no covered values leak into the
+// fluid.
+//
+void incflo::ProlongVelocity(const incflo& coarse)
+{
+    BL_PROFILE("incflo::ProlongVelocity()");
+
+    const MultiFab& cvel = *coarse.vel[0];
+    const int ncomp = AMREX_SPACEDIM;
+
+    int ratio = coarse.Geom(0).CellSize(0) / geom[0].CellSize(0) + 0.5;
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        if(lev > 0) ratio *= refRatio(lev - 1)[0];
+
+        // Coarse data on the coarsened grids of the level, with one layer of neighbours.
+        // Cells without data keep covered_val, like the covered cells.
+        MultiFab crse(amrex::coarsen(grids[lev], ratio), dmap[lev], ncomp, 1);
+        crse.setVal(covered_val);
+        crse.ParallelCopy(cvel, 0, 0, ncomp, 0, 1, coarse.Geom(0).periodicity());
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+
+            const auto& crse_arr = crse.array(mfi);
+            const auto& vel_arr = vel[lev]->array(mfi);
+
+            auto has_data = [&] (int i, int j, int k, int n)
+            {
+                return std::abs(crse_arr(i,j,k,n)) < 0.5 * covered_val;
+            };
+
+            for(int n = 0; n < ncomp; n++)
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                const IntVect iv(i,j,k);
+                const IntVect civ = amrex::coarsen(iv, ratio);
+
+                const Real c = crse_arr(civ[0],civ[1],civ[2],n);
+                if(!has_data(civ[0], civ[1], civ[2], n))
+                {
+                    continue;
+                }
+
+                Real v = c;
+                for(int d = 0; d < 3; d++)
+                {
+                    IntVect lo(civ), hi(civ);
+                    lo[d] -= 1;
+                    hi[d] += 1;
+
+                    // Minmod of the one-sided differences that exist
+                    Real slope = 0.0;
+                    const bool has_lo = has_data(lo[0], lo[1], lo[2], n);
+                    const bool has_hi = has_data(hi[0], hi[1], hi[2], n);
+                    if(has_lo && has_hi)
+                    {
+                        const Real dlo = c - crse_arr(lo[0],lo[1],lo[2],n);
+                        const Real dhi = crse_arr(hi[0],hi[1],hi[2],n) - c;
+                        if(dlo * dhi > 0.0)
+                        {
+                            slope = std::abs(dlo) < std::abs(dhi) ? dlo : dhi;
+                        }
+                    }
+
+                    // Position of the fine cell centre in the coarse cell, in (-1/2, 1/2)
+                    const Real xi = (iv[d] - civ[d] * ratio + 0.5) / ratio - 0.5;
+                    v += slope * xi;
+                }
+                vel_arr(i,j,k,n) = v;
+            }
+        }
+    }
+
+    FillVelocityBC(cur_time, 0);
+}
+
+//
+// Fill the pressure and pressure gradient of all levels by interpolation from level 0 of
+// coarse: trilinear between the nodes for p, piecewise constant for gp
+//
+void incflo::ProlongPressure(const incflo& coarse)
+{
+    BL_PROFILE("incflo::ProlongPressure()");
+
+    int ratio = coarse.Geom(0).CellSize(0) / geom[0].CellSize(0) + 0.5;
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        if(lev > 0) ratio *= refRatio(lev - 1)[0];
+
+        const BoxArray& nd_grids = amrex::convert(grids[lev], IntVect{1,1,1});
+
+        MultiFab crse_p(amrex::coarsen(nd_grids, ratio), dmap[lev], 1, 1);
+        crse_p.setVal(0.0);
+        crse_p.ParallelCopy(*coarse.p[0], 0, 0, 1, 0, 1, coarse.Geom(0).periodicity());
+
+        MultiFab crse_gp(amrex::coarsen(grids[lev], ratio), dmap[lev], AMREX_SPACEDIM, 0);
+        crse_gp.setVal(0.0);
+        crse_gp.ParallelCopy(*coarse.gp[0], 0, 0, AMREX_SPACEDIM, 0, 0, coarse.Geom(0).periodicity());
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*p[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+
+            const auto& crse_arr = crse_p.array(mfi);
+            const auto& p_arr = p[lev]->array(mfi);
+
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                const IntVect iv(i,j,k);
+                const IntVect civ = amrex::coarsen(iv, ratio);
+
+                Real w[3];
+                for(int d = 0; d < 3; d++)
+                {
+                    w[d] = Real(iv[d] - civ[d] * ratio) / ratio;
+                }
+
+                Real v = 0.0;
+                for(int kk = 0; kk < 2; kk++)
+                for(int jj = 0; jj < 2; jj++)
+                for(int ii = 0; ii < 2; ii++)
+                {
+                    const Real wt = (ii ? w[0] : 1.0 - w[0])
+                                  * (jj ? w[1] : 1.0 - w[1])
+                                  * (kk ? w[2] : 1.0 - w[2]);
+                    if(wt > 0.0)
+                    {
+                        v += wt * crse_arr(civ[0] + ii, civ[1] + jj, civ[2] + kk);
+                    }
+                }
+                p_arr(i,j,k) = v;
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*gp[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+
+            const auto& crse_arr = crse_gp.array(mfi);
+            const auto& gp_arr = gp[lev]->array(mfi);
+
+            for(int n = 0; n < AMREX_SPACEDIM; n++)
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                const IntVect civ = amrex::coarsen(IntVect(i,j,k), ratio);
+                gp_arr(i,j,k,n) = crse_arr(civ[0],civ[1],civ[2],n);
+            }
+        }
+
+        p[lev]->FillBoundary(geom[lev].periodicity());
+        gp[lev]->FillBoundary(geom[lev].periodicity());
+    }
+}
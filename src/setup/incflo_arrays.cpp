@@ -21,27 +21,19 @@ void incflo::AllocateArrays(int lev)
     vel_o[lev]->setVal(0.);
 
     // Pressure gradients
-    gp[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, MFInfo(), *ebfactory[lev]));
+    gp[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, ng_gp, MFInfo(), *ebfactory[lev]));
     gp[lev]->setVal(0.);
 
     // Viscosity
     eta[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
-    eta_old[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
+    eta_old[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, 0, MFInfo(), *ebfactory[lev]));
     eta[lev]->setVal(0.);
     eta_old[lev]->setVal(0.);
 
     // Strain-rate magnitude
-    strainrate[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
+    strainrate[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, 0, MFInfo(), *ebfactory[lev]));
     strainrate[lev]->setVal(0.);
 
-    // Vorticity
-    vort[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
-    vort[lev]->setVal(0.);
-
-    // Drag
-    drag[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
-    drag[lev]->setVal(0.);
-
     // Convective terms for diffusion equation
     conv[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, 0, MFInfo(), *ebfactory[lev]));
     conv_old[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, 0, MFInfo(), *ebfactory[lev]));
@@ -54,17 +46,23 @@ void incflo::AllocateArrays(int lev)
     divtau[lev]->setVal(0.);
     divtau_old[lev]->setVal(0.);
 
-    // Slopes in x-direction
-    xslopes[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, MFInfo(), *ebfactory[lev]));
-    xslopes[lev]->setVal(0.);
-
-    // Slopes in y-direction
-    yslopes[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, MFInfo(), *ebfactory[lev]));
-    yslopes[lev]->setVal(0.);
+    // Local time steps for steady_state runs
+    if(steady_state_lts)
+    {
+        lts_ratio[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
+        ro_lts[lev].reset(new MultiFab(grids[lev], dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
+        lts_ratio[lev]->setVal(1.);
+        ro_lts[lev]->setVal(0.);
+    }
 
-    // Slopes in z-direction
-    zslopes[lev].reset(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, MFInfo(), *ebfactory[lev]));
-    zslopes[lev]->setVal(0.);
+    // Running time-averaged statistics: a new fine level starts from the values of the coarser
+    // level, as averaging may have been going on for a while (on restart, they are read after)
+    if(stats_start_time >= 0.0)
+    {
+        stats[lev].reset(new MultiFab(grids[lev], dmap[lev], NumStatistics(), 0, MFInfo(), *ebfactory[lev]));
+        stats[lev]->setVal(0.);
+        if(lev > 0 && stats[lev-1]) FillStatisticsFromCoarse(lev, *stats[lev]);
+    }
 
     // ********************************************************************************
     // Node-based arrays
@@ -73,15 +71,11 @@ void incflo::AllocateArrays(int lev)
     const BoxArray & nd_grids = amrex::convert(grids[lev], IntVect{1,1,1});
 
     // Pressure
-    p0[lev].reset(new MultiFab(nd_grids, dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
+    p0[lev].reset(new MultiFab(nd_grids, dmap[lev], 1, ng_nodal, MFInfo(), *ebfactory[lev]));
     p0[lev]->setVal(0.);
-    p[lev].reset(new MultiFab(nd_grids, dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
+    p[lev].reset(new MultiFab(nd_grids, dmap[lev], 1, ng_nodal, MFInfo(), *ebfactory[lev]));
     p[lev]->setVal(0.);
 
-    // Divergence of velocity field
-    divu[lev].reset(new MultiFab(nd_grids, dmap[lev], 1, nghost, MFInfo(), *ebfactory[lev]));
-    divu[lev]->setVal(0.);
-
     // ********************************************************************************
     // Face-based arrays
     // ********************************************************************************
@@ -144,10 +138,10 @@ void incflo::RegridArrays(int lev)
 	vel_o[lev] = std::move(vel_o_new);
 
 	// Pressure gradients
-	std::unique_ptr<MultiFab> gp_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, 
+	std::unique_ptr<MultiFab> gp_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, ng_gp, 
                                                   MFInfo(), *ebfactory[lev]));
     gp_new->setVal(0.);
-	gp_new->copy(*gp[lev], 0, 0, gp[lev]->nComp(), 0, nghost);
+	gp_new->copy(*gp[lev], 0, 0, gp[lev]->nComp(), 0, ng_gp);
 	gp[lev] = std::move(gp_new);
 
 	// Apparent viscosity
@@ -157,69 +151,69 @@ void incflo::RegridArrays(int lev)
 	eta_new->copy(*eta[lev], 0, 0, 1, 0, nghost);
 	eta[lev] = std::move(eta_new);
 
-	std::unique_ptr<MultiFab> eta_old_new(new MultiFab(grids[lev], dmap[lev], 1, nghost,
+	std::unique_ptr<MultiFab> eta_old_new(new MultiFab(grids[lev], dmap[lev], 1, 0,
                                                        MFInfo(), *ebfactory[lev]));
 	eta_old_new->setVal(0.);
-	eta_old_new->copy(*eta_old[lev], 0, 0, 1, 0, nghost);
+	eta_old_new->copy(*eta_old[lev], 0, 0, 1, 0, 0);
 	eta_old[lev] = std::move(eta_old_new);
 
 	// Strain-rate magnitude
-	std::unique_ptr<MultiFab> strainrate_new(new MultiFab(grids[lev], dmap[lev], 1, nghost,
+	std::unique_ptr<MultiFab> strainrate_new(new MultiFab(grids[lev], dmap[lev], 1, 0,
                                                           MFInfo(), *ebfactory[lev]));
 	strainrate[lev] = std::move(strainrate_new);
 	strainrate[lev]->setVal(0.);
 
-	// Vorticity
-	std::unique_ptr<MultiFab> vort_new(new MultiFab(grids[lev], dmap[lev], 1, nghost,
-                                                    MFInfo(), *ebfactory[lev]));
-	vort[lev] = std::move(vort_new);
-	vort[lev]->setVal(0.);
-
-	// Drag
-	std::unique_ptr<MultiFab> drag_new(new MultiFab(grids[lev], dmap[lev], 1, nghost,
-                                                    MFInfo(), *ebfactory[lev]));
-	drag[lev] = std::move(drag_new);
-	drag[lev]->setVal(0.);
-
     // Convective terms
-    std::unique_ptr<MultiFab> conv_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost,
+    std::unique_ptr<MultiFab> conv_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, 0,
                                                     MFInfo(), *ebfactory[lev]));
     conv[lev] = std::move(conv_new);
     conv[lev]->setVal(0.);
 
-    std::unique_ptr<MultiFab> conv_old_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost,
+    std::unique_ptr<MultiFab> conv_old_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, 0,
                                                         MFInfo(), *ebfactory[lev]));
     conv_old[lev] = std::move(conv_old_new);
     conv_old[lev]->setVal(0.);
 
     // Divergence of stress tensor terms 
-    std::unique_ptr<MultiFab> divtau_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost,
+    std::unique_ptr<MultiFab> divtau_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, 0,
                                                       MFInfo(), *ebfactory[lev]));
     divtau[lev] = std::move(divtau_new);
     divtau[lev]->setVal(0.);
 
-    std::unique_ptr<MultiFab> divtau_old_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost,
+    std::unique_ptr<MultiFab> divtau_old_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, 0,
                                                           MFInfo(), *ebfactory[lev]));
     divtau_old[lev] = std::move(divtau_old_new);
     divtau_old[lev]->setVal(0.);
 
-    // Slopes in x-direction
-    std::unique_ptr<MultiFab> xslopes_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, 
-                                                       MFInfo(), *ebfactory[lev]));
-    xslopes[lev] = std::move(xslopes_new);
-    xslopes[lev] -> setVal(0.);
+    // Local time steps, recomputed at the start of every step
+    if(lts_ratio[lev])
+    {
+        std::unique_ptr<MultiFab> lts_ratio_new(new MultiFab(grids[lev], dmap[lev], 1, nghost,
+                                                             MFInfo(), *ebfactory[lev]));
+        lts_ratio[lev] = std::move(lts_ratio_new);
+        lts_ratio[lev]->setVal(1.);
 
-    // Slopes in y-direction
-    std::unique_ptr<MultiFab> yslopes_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, 
-                                                       MFInfo(), *ebfactory[lev]));
-    yslopes[lev] = std::move(yslopes_new);
-    yslopes[lev] -> setVal(0.);
+        std::unique_ptr<MultiFab> ro_lts_new(new MultiFab(grids[lev], dmap[lev], 1, nghost,
+                                                          MFInfo(), *ebfactory[lev]));
+        ro_lts[lev] = std::move(ro_lts_new);
+        ro_lts[lev]->setVal(0.);
+    }
 
-    // Slopes in z-direction
-    std::unique_ptr<MultiFab> zslopes_new(new MultiFab(grids[lev], dmap[lev], AMREX_SPACEDIM, nghost, 
-                                                       MFInfo(), *ebfactory[lev]));
-    zslopes[lev] = std::move(zslopes_new);
-    zslopes[lev] -> setVal(0.);
+    // Running time-averaged statistics: where the level is new, they start from the values of
+    // the coarser level (piecewise constant), so that the averages are not reset
+    if(stats[lev])
+    {
+        const int nstats = NumStatistics();
+        std::unique_ptr<MultiFab> stats_new(new MultiFab(grids[lev], dmap[lev], nstats, 0,
+                                                         MFInfo(), *ebfactory[lev]));
+        stats_new->setVal(0.);
+
+        if(lev > 0 && stats[lev-1]) FillStatisticsFromCoarse(lev, *stats_new);
+
+        // The old data of the level where it had data
+        stats_new->copy(*stats[lev], 0, 0, nstats, 0, 0);
+        stats[lev] = std::move(stats_new);
+    }
 
     /****************************************************************************
     * Node-based Arrays                                                        *
@@ -228,23 +222,18 @@ void incflo::RegridArrays(int lev)
     // Pressures, projection vars
     const BoxArray & nd_grids = amrex::convert(grids[lev], IntVect{1,1,1});
 
-    std::unique_ptr<MultiFab> p_new(new MultiFab(nd_grids, dmap[lev], 1, nghost, 
+    std::unique_ptr<MultiFab> p_new(new MultiFab(nd_grids, dmap[lev], 1, ng_nodal, 
                                                  MFInfo(), *ebfactory[lev]));
     p_new->setVal(0.0);
-    p_new->copy(*p[lev],0,0,1,0,nghost);
+    p_new->copy(*p[lev],0,0,1,0,ng_nodal);
     p[lev] = std::move(p_new);
 
-    std::unique_ptr<MultiFab> p0_new(new MultiFab(nd_grids, dmap[lev], 1, nghost, 
+    std::unique_ptr<MultiFab> p0_new(new MultiFab(nd_grids, dmap[lev], 1, ng_nodal, 
                                                   MFInfo(), *ebfactory[lev]));
     p0_new->setVal(0.0);
-    p0_new->copy(*p0[lev],0,0,1,0,nghost);
+    p0_new->copy(*p0[lev],0,0,1,0,ng_nodal);
     p0[lev] = std::move(p0_new);
 
-    std::unique_ptr<MultiFab> divu_new(new MultiFab(nd_grids, dmap[lev], 1, nghost, 
-                                                    MFInfo(), *ebfactory[lev]));
-    divu[lev] = std::move(divu_new);
-    divu[lev]->setVal(0.);
-
     /****************************************************************************
     * Face-based Arrays                                                        *
     ****************************************************************************/
@@ -299,26 +288,26 @@ void incflo::ResizeArrays()
 	// Pressure gradients
 	gp.resize(max_level + 1);
 
-    // Derived quantities: viscosity, strainrate, vorticity, div(u)
+    // Derived quantities: viscosity, strainrate
 	eta.resize(max_level + 1);
 	eta_old.resize(max_level + 1);
     strainrate.resize(max_level + 1);
-	vort.resize(max_level + 1);
-	drag.resize(max_level + 1);
-	divu.resize(max_level + 1);
+	stats.resize(max_level + 1);
 
     // Convective terms u grad u 
     conv.resize(max_level + 1);
     conv_old.resize(max_level + 1);
     divtau.resize(max_level + 1);
     divtau_old.resize(max_level + 1);
+    lts_ratio.resize(max_level + 1);
+    ro_lts.resize(max_level + 1);
 
 	// MAC velocities used for defining convective term
 	m_u_mac.resize(max_level + 1);
 	m_v_mac.resize(max_level + 1);
 	m_w_mac.resize(max_level + 1);
 
-    // Slopes used for upwinding convective terms
+    // Slopes used for upwinding convective terms (scratch buffers, see AcquireSlopes)
 	xslopes.resize(max_level + 1);
 	yslopes.resize(max_level + 1);
 	zslopes.resize(max_level + 1);
@@ -330,9 +319,11 @@ void incflo::ResizeArrays()
 	bc_jhi.resize(max_level + 1);
 	bc_klo.resize(max_level + 1);
 	bc_khi.resize(max_level + 1);
+	bc_list.resize(max_level + 1);
 
 	// EB factory
 	ebfactory.resize(max_level + 1);
+	eb_tiles.resize(max_level + 1);
 }
 
 void incflo::MakeBCArrays()
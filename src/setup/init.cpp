@@ -24,14 +24,17 @@ void incflo::ReadParameters()
 
 		pp.query("regrid_int", regrid_int);
         pp.query("refine_cutcells", refine_cutcells);
+        pp.query("remove_covered_grids", remove_covered_grids);
 
 		pp.query("check_file", check_file);
 		pp.query("check_int", check_int);
 		pp.query("restart", restart_file);
+		pp.query("regrid_on_restart", regrid_on_restart);
 
 		pp.query("plot_file", plot_file);
 		pp.query("plot_int", plot_int);
 		pp.query("plot_per", plot_per);
+		pp.query("plot_single_precision", plot_single_precision);
 
         // Which variables to write to plotfile
         pltVarCount = 0;
@@ -86,9 +89,37 @@ void incflo::ReadParameters()
         pp.query("verbose", incflo_verbose);
 		pp.query("cfl", cfl);
 		pp.query("fixed_dt", fixed_dt);
+        pp.query("implicit_viscosity", implicit_viscosity);
+        pp.query("implicit_viscosity_tol", implicit_viscosity_tol);
+        pp.query("implicit_viscosity_max_iter", implicit_viscosity_max_iter);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(implicit_viscosity_max_iter >= 2,
+                                         "incflo.implicit_viscosity_max_iter must be at least 2");
+        viscous_dt_limit = !implicit_viscosity;
 		pp.query("steady_state_tol", steady_state_tol);
+        pp.query("steady_state_lts", steady_state_lts);
+        pp.query("lts_cfl_max", lts_cfl_max);
+        pp.query("lts_cfl_growth", lts_cfl_growth);
+        pp.query("lts_max_ratio", lts_max_ratio);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!steady_state_lts || steady_state,
+                                         "incflo.steady_state_lts requires steady_state = 1");
+        AMREX_ALWAYS_ASSERT(lts_cfl_growth >= 1.0 && lts_max_ratio >= 1.0);
+        pp.query("steady_state_method", steady_state_method);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(steady_state_method == "march" ||
+                                         steady_state_method == "anderson",
+                                         "incflo.steady_state_method must be march or anderson");
+        pp.query("grid_sequencing", grid_sequencing);
+        pp.query("grid_sequencing_max_step", grid_sequencing_max_step);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(grid_sequencing <= 0 || steady_state,
+                                         "incflo.grid_sequencing requires steady_state = 1");
         pp.query("initial_iterations", initial_iterations);
         pp.query("do_initial_proj", do_initial_proj);
+        pp.query("overlap_comm", overlap_comm);
+
+        int use_scratch_pool = 1;
+        pp.query("scratch_pool", use_scratch_pool);
+        scratch.setEnabled(use_scratch_pool != 0);
+
+        pp.query("eb_cache_dir", eb_cache_dir);
 
         // Physics
 		pp.queryarr("delp", delp, 0, AMREX_SPACEDIM);
@@ -185,6 +216,11 @@ void incflo::ReadParameters()
             amrex::Abort("Unknown fluid_model! Choose either newtonian, powerlaw, bingham, hb, smd");
         }
 
+        constant_viscosity = (fluid_model == "newtonian");
+        pp.query("constant_viscosity", constant_viscosity);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!constant_viscosity || fluid_model == "newtonian",
+                                         "incflo.constant_viscosity requires fluid_model = newtonian");
+
         // Get cyclicity, (to pass to Fortran)
         Vector<int> is_cyclic(AMREX_SPACEDIM);
         for(int dir = 0; dir < AMREX_SPACEDIM; dir++)
@@ -199,11 +235,22 @@ void incflo::ReadParameters()
                          &n, &tau_0, &papa_reg, &eta_0,
                          fluid_model.c_str(), fluid_model.size());
 	}
+    {
+        // Prefix stats
+		ParmParse pp("stats");
+		pp.query("start_time", stats_start_time);
+		pp.query("int", stats_int);
+		pp.query("plot_int", stats_plot_int);
+		pp.query("plot_file", stats_plot_file);
+    }
     {
         // Prefix cylinder
 		ParmParse pp("cylinder");
 		pp.query("speed", cyl_speed);
     }
+
+    // Prefix timer
+    PhaseTimer::readParameters();
 }
 
 void incflo::PostInit(int restart_flag)
@@ -225,12 +272,37 @@ void incflo::PostInit(int restart_flag)
                                                    bc_jlo, bc_jhi,
                                                    bc_klo, bc_khi, nghost, cyl_speed));
 
+    // The density of the solves changes with the local time steps
+    diffusion_equation->setConstantCoefficients(constant_viscosity && !steady_state_lts);
+
+    // The stages of grid sequencing must not touch the sample and force files of the run
+    sampler.reset(new Sampler(this, &ebfactory, !is_stage));
+    force_monitor.reset(new ForceMonitor(!is_stage));
+    if(restart_flag) force_monitor->restart(cur_time);
+
+    if(steady_state && steady_state_method == "anderson")
+    {
+        anderson.reset(new AndersonAcceleration());
+    }
+
     // Initial fluid arrays: pressure, velocity, density, viscosity
     if(!restart_flag)
     {
         InitFluid();
     }
 
+    // Grid sequencing: start from the steady state on coarser grids
+    std::unique_ptr<incflo> sequence;
+    if(!restart_flag && grid_sequencing > 0)
+    {
+        sequence = SolveCoarseStages();
+        coarse_stage = sequence.get();
+    }
+    if(coarse_stage)
+    {
+        ProlongVelocity(*coarse_stage);
+    }
+
     // Set the background pressure and gradients in "DELP" cases
     SetBackgroundPressure();
 
@@ -238,15 +310,27 @@ void incflo::PostInit(int restart_flag)
     FillScalarBC();
     FillVelocityBC(cur_time, 0);
 
+    // A constant viscosity is only computed here
+    if(constant_viscosity)
+    {
+        UpdateDerivedQuantities();
+    }
+
     // Project the initial velocity field to make it divergence free
     // Perform initial iterations to find pressure distribution
     if(!restart_flag)
     {
         if (do_initial_proj)
             InitialProjection();
+
+        // The initial projection resets the pressure, which the iterations start from
+        if (coarse_stage)
+            ProlongPressure(*coarse_stage);
+
         if (initial_iterations > 0)
             InitialIterations();
     }
+    coarse_stage = nullptr;
 }
 
 void incflo::InitFluid()
@@ -263,17 +347,19 @@ void incflo::InitFluid()
         Real dy = geom[lev].CellSize(1);
         Real dz = geom[lev].CellSize(2);
 
-        // We deliberately don't tile this loop since we will be looping
-        //    over bc's on faces and it makes more sense to do this one grid at a time
-        for(MFIter mfi(*ro[lev], false); mfi.isValid(); ++mfi)
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*ro[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
         {
-            const Box& bx = mfi.validbox();
+            const Box& bx = mfi.tilebox();
+            const Box& gbx = mfi.growntilebox();
             const Box& sbx = (*ro[lev])[mfi].box();
             init_fluid(sbx.loVect(), sbx.hiVect(),
                        bx.loVect(), bx.hiVect(),
+                       gbx.loVect(), gbx.hiVect(),
                        domain.loVect(), domain.hiVect(),
                        (*ro[lev])[mfi].dataPtr(),
-                       (*p[lev])[mfi].dataPtr(),
                        (*vel[lev])[mfi].dataPtr(),
                        (*eta[lev])[mfi].dataPtr(),
                        &dx, &dy, &dz,
@@ -299,6 +385,9 @@ void incflo::SetBCTypes()
                     bc_klo[lev]->dataPtr(), bc_khi[lev]->dataPtr(),
                     domain.loVect(), domain.hiVect(),
                     &dx, &dy, &dz, &xlen, &ylen, &zlen, &nghost);
+
+        // Rebuilt with the new BC types when next needed
+        bc_list[lev].reset();
     }
 }
 
@@ -332,25 +421,39 @@ void incflo::SetBackgroundPressure()
 
         Box domain(geom[lev].Domain());
 
-        // We deliberately don't tile this loop since we will be looping
-        //    over bc's on faces and it makes more sense to do this one grid at a time
-        for(MFIter mfi(*ro[lev], false); mfi.isValid(); ++mfi)
+        // set_p0 fills the (nodal) grown tile box, and every call returns the same gp0.
+        //    Each thread works on its own copy of gp0 so that there are no concurrent writes.
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
         {
-            const Box& bx = mfi.validbox();
-
-            set_p0(bx.loVect(), bx.hiVect(),
-                   domain.loVect(), domain.hiVect(),
-                   BL_TO_FORTRAN_ANYD((*p0[lev])[mfi]),
-                   &gp0[0],
-                   &dx, &dy, &dz, &xlen, &ylen, &zlen,
-                   &delp_dir,
-                   bc_ilo[lev]->dataPtr(),
-                   bc_ihi[lev]->dataPtr(),
-                   bc_jlo[lev]->dataPtr(),
-                   bc_jhi[lev]->dataPtr(),
-                   bc_klo[lev]->dataPtr(),
-                   bc_khi[lev]->dataPtr(),
-                   &nghost);
+            Vector<Real> gp0_tile(3, 0.0);
+            bool has_tiles = false;
+
+            for(MFIter mfi(*p0[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.growntilebox();
+
+                set_p0(bx.loVect(), bx.hiVect(),
+                       domain.loVect(), domain.hiVect(),
+                       BL_TO_FORTRAN_ANYD((*p0[lev])[mfi]),
+                       gp0_tile.dataPtr(),
+                       &dx, &dy, &dz, &xlen, &ylen, &zlen,
+                       &delp_dir,
+                       bc_ilo[lev]->dataPtr(),
+                       bc_ihi[lev]->dataPtr(),
+                       bc_jlo[lev]->dataPtr(),
+                       bc_jhi[lev]->dataPtr(),
+                       bc_klo[lev]->dataPtr(),
+                       bc_khi[lev]->dataPtr(),
+                       &nghost);
+                has_tiles = true;
+            }
+
+#ifdef _OPENMP
+#pragma omp critical (incflo_set_p0)
+#endif
+            if(has_tiles) gp0 = gp0_tile;
         }
         p0[lev]->FillBoundary(p0_periodicity);
     }
@@ -410,8 +513,6 @@ void incflo::InitialProjection()
         PrintMaxValues(time);
     }
 
-    print_state(*divu[0],{0,0,0});
-
     // Need to add this call here so that the MACProjection internal arrays
     //  are allocated so that the cell-centered projection can use the MAC
     //  data structures and set_velocity_bcs routine
@@ -9,8 +9,8 @@ contains
 !  Subroutine: init_fluid                                              !
 !                                                                      !
 !^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^!
-   subroutine init_fluid(slo, shi, lo, hi, &
-                         domlo, domhi, ro, p, vel, eta, & 
+   subroutine init_fluid(slo, shi, lo, hi, glo, ghi, &
+                         domlo, domhi, ro, vel, eta, & 
                          dx, dy, dz, xlength, ylength, zlength, probtype) &
       bind(C, name="init_fluid")
 
@@ -21,11 +21,11 @@ contains
 
 ! Dummy arguments .....................................................//
       integer(c_int), intent(in   ) ::  lo(3),  hi(3)
+      integer(c_int), intent(in   ) :: glo(3), ghi(3)
       integer(c_int), intent(in   ) :: slo(3), shi(3)
       integer(c_int), intent(in   ) :: domlo(3),domhi(3)
 
       real(rt), intent(inout) ::  ro(slo(1):shi(1), slo(2):shi(2), slo(3):shi(3)  )
-      real(rt), intent(inout) ::   p(slo(1):shi(1), slo(2):shi(2), slo(3):shi(3)  )
       real(rt), intent(inout) :: vel(slo(1):shi(1), slo(2):shi(2), slo(3):shi(3),3)
       real(rt), intent(inout) :: eta(slo(1):shi(1), slo(2):shi(2), slo(3):shi(3)  )
 
@@ -33,12 +33,13 @@ contains
       real(rt), intent(in   ) :: xlength, ylength, zlength
       integer,  intent(in   ) :: probtype
 
-      ! Set the initial fluid density and viscosity
-      ro  = ro_0
-      eta = mu
-      vel(:,:,:,1) = ic_u
-      vel(:,:,:,2) = ic_v
-      vel(:,:,:,3) = ic_w
+      ! Set the initial fluid density and viscosity, including the ghost cells
+      ! (glo:ghi is the grown tile box, so tiles never overlap)
+      ro (glo(1):ghi(1),glo(2):ghi(2),glo(3):ghi(3)) = ro_0
+      eta(glo(1):ghi(1),glo(2):ghi(2),glo(3):ghi(3)) = mu
+      vel(glo(1):ghi(1),glo(2):ghi(2),glo(3):ghi(3),1) = ic_u
+      vel(glo(1):ghi(1),glo(2):ghi(2),glo(3):ghi(3),2) = ic_v
+      vel(glo(1):ghi(1),glo(2):ghi(2),glo(3):ghi(3),3) = ic_w
       
       if (probtype == 1) call taylor_green(lo, hi, vel, slo, shi, dx, dy, dz, domlo)
       if (probtype == 2) call double_shear_layer(lo, hi, vel, slo, shi, dx, dy, dz, domlo)
@@ -4,6 +4,10 @@
 !  Purpose: Set the pressure field inside the bed assuming gravity     !
 !           is acting in the negative y-direction.                     !
 !                                                                      !
+!  Only p0 in lo:hi (e.g. the grown nodal tile box) is written, and    !
+!  the values don't depend on the box, so tiles can be done in         !
+!  parallel. gp0 is the same for all boxes.                            !
+!                                                                      !
 !^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^!
 subroutine set_p0(lo, hi, domlo, domhi, &
                   p0, slo, shi, &
@@ -14,7 +18,7 @@ subroutine set_p0(lo, hi, domlo, domhi, &
 
    use bc,       only: dim_bc, bc_type, bc_p, bc_defined
    use bc,       only: pinf_, pout_, minf_
-   use constant, only: delp, gravity, ro_0, ic_p
+   use constant, only: delp_in => delp, gravity, ro_0, ic_p
    use constant, only: zero, undefined, is_defined
 
    use amrex_fort_module, only : ar => amrex_real
@@ -50,6 +54,9 @@ subroutine set_p0(lo, hi, domlo, domhi, &
    integer :: nlft, nbot, ndwn, nrgt, ntop, nup
    integer :: delp_dir
 
+   ! Pressure drop: local copy, so that concurrent calls don't write the module variable
+   real(ar) :: delp(3)
+
    ! Gas pressure at the axial location j
    real(ar) :: pj, p_lo, p_hi
 
@@ -60,6 +67,7 @@ subroutine set_p0(lo, hi, domlo, domhi, &
    gp0(:) = 0.d0
    pj     = 0.d0
 
+   delp     = delp_in
    delp_dir = delp_dir_in
 
 ! ---------------------------------------------------------------->>>
@@ -179,7 +187,7 @@ else if ( (delp_dir .ge. 0) .and. (delp_dir .ne. delp_dir_in) ) then
 else
    if (.not. is_defined(ic_p)) goto 60
    if (gravity(1).ne.0.d0 .or. gravity(2).ne.0.d0 .or. gravity(3).ne.0.d0) goto 60
-      p0(:,:,:) = ic_p
+      p0(lo(1):hi(1),lo(2):hi(2),lo(3):hi(3)) = ic_p
       gp0(:) = 0.d0
 end if
 
@@ -194,35 +202,34 @@ end if
       !  This hack allows to set the IC pressure  at L-dx/2
       !  -> reference value for pressure, AKA IC_P,
       !  is set at the last cell center location.
-      real(ar) :: offset = - 0.5_ar
+      !  The pressure at node i is pj + dpodx*dx*(domhi - i - offset)
+      !  (offset is not initialized in its declaration, which would make it a
+      !  saved variable shared between calls and threads)
+      real(ar) :: offset
+
+      offset = -0.5_ar
       if (delp_dir .ne. delp_dir_in) offset = -1.0_ar
 
       if (abs(delp(1)) > epsilon(zero)) then
          dpodx = delp(1)/xlength
-         pj = pj - dpodx*dx*(hi(1)-domhi(1)+ng+2 + offset )
-         do i = shi(1), slo(1), -1
-            pj = pj + dpodx*dx
-            p0(i,slo(2):shi(2),slo(3):shi(3)) = pj
+         do i = lo(1), hi(1)
+            p0(i,lo(2):hi(2),lo(3):hi(3)) = pj + dpodx*dx*(domhi(1) - i - offset)
          enddo
          gp0(1) = -dpodx
       endif
 
       if (abs(delp(2)) > epsilon(zero)) then
          dpody = delp(2)/ylength
-         pj = pj - dpody*dy*(hi(2)-domhi(2)+ng+2 + offset )
-         do j = shi(2), slo(2), -1
-            pj = pj + dpody*dy
-            p0(slo(1):shi(1),j,slo(3):shi(3)) = pj
+         do j = lo(2), hi(2)
+            p0(lo(1):hi(1),j,lo(3):hi(3)) = pj + dpody*dy*(domhi(2) - j - offset)
          enddo
          gp0(2) = -dpody
       endif
 
       if (abs(delp(3)) > epsilon(zero)) then
          dpodz = delp(3)/zlength
-         pj = pj - dpodz*dz*(hi(3)-domhi(3)+ng+2 + offset )
-         do k = shi(3), slo(3), -1
-            pj = pj + dpodz*dz
-            p0(slo(1):shi(1),slo(2):shi(2),k) = pj
+         do k = lo(3), hi(3)
+            p0(lo(1):hi(1),lo(2):hi(2),k) = pj + dpodz*dz*(domhi(3) - k - offset)
          end do
          gp0(3) = -dpodz
       endif
@@ -249,7 +256,7 @@ end if
    ! Either a PO was not specified and/or a PO was specified but not the
    ! pressure at the outlet
    if (.not. is_defined(pj)) then
-      p0 = zero
+      p0(lo(1):hi(1),lo(2):hi(2),lo(3):hi(3)) = zero
       gp0  = zero
       goto 100
    endif
@@ -267,14 +274,14 @@ end if
 
       if (gravity(1) <= 0.0d0) then
          do i = domhi(1)+1, domlo(1), -1
-            if (i <= shi(1) .and. i >= slo(1)) &
-               p0(i,:,:) = pj
+            if (i <= hi(1) .and. i >= lo(1)) &
+               p0(i,lo(2):hi(2),lo(3):hi(3)) = pj
             pj = pj + dpodx*dx
          enddo
       else
          do i = domlo(1), domhi(1)+1
-            if (i <= shi(1) .and. i >= slo(1)) &
-               p0(i,:,:) = pj
+            if (i <= hi(1) .and. i >= lo(1)) &
+               p0(i,lo(2):hi(2),lo(3):hi(3)) = pj
             pj = pj - dpodx*dx
          enddo
       endif
@@ -287,14 +294,14 @@ end if
 
       if (gravity(2) <= 0.0d0) then
          do j = domhi(2)+1, domlo(2), -1
-            if (j <= shi(2) .and. j >= slo(2)) &
-               p0(:,j,:) = pj
+            if (j <= hi(2) .and. j >= lo(2)) &
+               p0(lo(1):hi(1),j,lo(3):hi(3)) = pj
             pj = pj + dpody*dy
          enddo
       else
          do j = domlo(2),domhi(2)+1
-            if (j <= shi(2) .and. j >= slo(2)) &
-               p0(:,j,:) = pj
+            if (j <= hi(2) .and. j >= lo(2)) &
+               p0(lo(1):hi(1),j,lo(3):hi(3)) = pj
             pj = pj - dpody*dy
          enddo
       endif
@@ -307,14 +314,14 @@ end if
 
       if(gravity(3) <= 0.0d0) then
          do k = domhi(3)+1, domlo(3), -1
-            if (k <= shi(3) .and. k >= slo(3)) &
-               p0(:,:,k) = pj
+            if (k <= hi(3) .and. k >= lo(3)) &
+               p0(lo(1):hi(1),lo(2):hi(2),k) = pj
             pj = pj + dpodz*dz
          enddo
       else
          do k = domlo(3),domhi(3)+1
-            if (k <= shi(3) .and. k >= slo(3)) &
-               p0(:,:,k) = pj
+            if (k <= hi(3) .and. k >= lo(3)) &
+               p0(lo(1):hi(1),lo(2):hi(2),k) = pj
             pj = pj - dpodz*dz
          enddo
       endif
@@ -334,18 +341,18 @@ end if
 
       offset = 1
 
-      nlft = max(0,domlo(1)-slo(1)+offset)
-      nbot = max(0,domlo(2)-slo(2)+offset)
-      ndwn = max(0,domlo(3)-slo(3)+offset)
+      nlft = max(0,domlo(1)-lo(1)+offset)
+      nbot = max(0,domlo(2)-lo(2)+offset)
+      ndwn = max(0,domlo(3)-lo(3)+offset)
 
-      nrgt = max(0,shi(1)-domhi(1))
-      ntop = max(0,shi(2)-domhi(2))
-      nup  = max(0,shi(3)-domhi(3))
+      nrgt = max(0,hi(1)-domhi(1))
+      ntop = max(0,hi(2)-domhi(2))
+      nup  = max(0,hi(3)-domhi(3))
    end block
 
    if (nlft .gt. 0) then
-      do k=slo(3),shi(3)
-         do j=slo(2),shi(2)
+      do k=lo(3),hi(3)
+         do j=lo(2),hi(2)
 
             kbc = k
             jbc = j
@@ -357,7 +364,7 @@ end if
             case (pinf_, pout_)
 
                bcv = bct_ilo(jbc,kbc,2)
-               p0(slo(1):domlo(1)  ,j,k) = bc_p(bcv)
+               p0(lo(1):domlo(1)  ,j,k) = bc_p(bcv)
 
             end select
          end do
@@ -365,8 +372,8 @@ end if
    endif
 
    if (nrgt .gt. 0) then
-      do k=slo(3),shi(3)
-         do j=slo(2),shi(2)
+      do k=lo(3),hi(3)
+         do j=lo(2),hi(2)
 
             kbc = k
             jbc = j
@@ -378,7 +385,7 @@ end if
             case (pinf_, pout_)
 
                bcv = bct_ihi(jbc,kbc,2)
-               p0(domhi(1)+1:shi(1),j,k) = bc_p(bcv)
+               p0(domhi(1)+1:hi(1),j,k) = bc_p(bcv)
 
             end select
          end do
@@ -386,8 +393,8 @@ end if
    endif
 
    if (nbot .gt. 0) then
-      do k=slo(3),shi(3)
-         do i=slo(1),shi(1)
+      do k=lo(3),hi(3)
+         do i=lo(1),hi(1)
 
             kbc = k
             ibc = i
@@ -399,7 +406,7 @@ end if
             case (pinf_, pout_)
 
                bcv = bct_jlo(ibc,kbc,2)
-               p0(i,slo(2):domlo(2)  ,k) = bc_p(bcv)
+               p0(i,lo(2):domlo(2)  ,k) = bc_p(bcv)
 
             end select
          end do
@@ -407,8 +414,8 @@ end if
    endif
 
    if (ntop .gt. 0) then
-      do k = slo(3),shi(3)
-         do i = slo(1),shi(1)
+      do k = lo(3),hi(3)
+         do i = lo(1),hi(1)
 
             kbc = k
             ibc = i
@@ -420,7 +427,7 @@ end if
             case (pinf_, pout_)
 
                bcv = bct_jhi(ibc,kbc,2)
-               p0(i,domhi(2)+1:shi(2),k) = bc_p(bcv)
+               p0(i,domhi(2)+1:hi(2),k) = bc_p(bcv)
 
             end select
          end do
@@ -428,8 +435,8 @@ end if
    endif
 
    if (ndwn .gt. 0) then
-      do j=slo(2),shi(2)
-         do i=slo(1),shi(1)
+      do j=lo(2),hi(2)
+         do i=lo(1),hi(1)
 
             jbc = j
             ibc = i
@@ -441,7 +448,7 @@ end if
             case (pinf_, pout_)
 
                bcv = bct_klo(ibc,jbc,2)
-               p0(i,j,slo(3):domlo(3)  ) = bc_p(bcv)
+               p0(i,j,lo(3):domlo(3)  ) = bc_p(bcv)
 
             end select
          end do
@@ -449,8 +456,8 @@ end if
    endif
 
    if (nup .gt. 0) then
-      do j=slo(2),shi(2)
-         do i=slo(1),shi(1)
+      do j=lo(2),hi(2)
+         do i=lo(1),hi(1)
 
             jbc = j
             ibc = i
@@ -462,7 +469,7 @@ end if
             case (pinf_, pout_)
 
                bcv = bct_khi(ibc,jbc,2)
-               p0(i,j,domhi(3)+1:shi(3)) = bc_p(bcv)
+               p0(i,j,domhi(3)+1:hi(3)) = bc_p(bcv)
 
             end select
          end do
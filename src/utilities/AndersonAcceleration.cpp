@@ -0,0 +1,290 @@
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <AndersonAcceleration.H>
+
+#include <cmath>
+#include <utility>
+
+using namespace amrex;
+
+AndersonAcceleration::AndersonAcceleration()
+{
+    // Get inputs from ParmParse
+    readParameters();
+}
+
+void AndersonAcceleration::readParameters()
+{
+    ParmParse pp("anderson");
+
+    pp.query("depth", depth);
+    pp.query("relax", relax);
+    pp.query("max_coef", max_coef);
+    pp.query("restart_factor", restart_factor);
+    pp.query("regularization", regularization);
+    pp.query("verbose", verbose);
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(depth >= 1, "anderson.depth must be at least 1");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(relax > 0.0 && relax <= 1.0, "anderson.relax must be in (0, 1]");
+}
+
+void AndersonAcceleration::reset()
+{
+    df.clear();
+    dg.clear();
+    has_prev = false;
+    f_min = -1.0;
+}
+
+void AndersonAcceleration::define(State& s, const Vector<MultiFab*>& x)
+{
+    if(compatible(s, x)) return;
+
+    s.resize(x.size());
+    for(int i = 0; i < int(x.size()); i++)
+    {
+        s[i].reset(new MultiFab(x[i]->boxArray(), x[i]->DistributionMap(),
+                                x[i]->nComp(), x[i]->nGrow()));
+    }
+}
+
+bool AndersonAcceleration::compatible(const State& s, const Vector<MultiFab*>& x)
+{
+    if(s.size() != x.size()) return false;
+
+    for(int i = 0; i < int(x.size()); i++)
+    {
+        if(s[i]->boxArray() != x[i]->boxArray() ||
+           s[i]->DistributionMap() != x[i]->DistributionMap() ||
+           s[i]->nComp() != x[i]->nComp() ||
+           s[i]->nGrow() != x[i]->nGrow()) return false;
+    }
+    return true;
+}
+
+Real AndersonAcceleration::localDot(const State& a, const State& b) const
+{
+    Real sum = 0.0;
+    for(int s = 0; s < int(a.size()); s++)
+    {
+        const int nc = a[s]->nComp();
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:sum) if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*a[s], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+
+            const auto& a_arr = a[s]->array(mfi);
+            const auto& b_arr = b[s]->array(mfi);
+            const auto& w_arr = weight[s]->array(mfi);
+
+            for(int n = 0; n < nc; n++)
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                // No product with zero weight: covered cells hold covered_val
+                if(w_arr(i,j,k) > 0.0)
+                {
+                    sum += w_arr(i,j,k) * a_arr(i,j,k,n) * b_arr(i,j,k,n);
+                }
+            }
+        }
+    }
+    return sum;
+}
+
+//
+// Gaussian elimination with partial pivoting. A is stored by rows, b holds the solution on return.
+//
+bool AndersonAcceleration::solve(Vector<Real>& A, Vector<Real>& b, int n)
+{
+    for(int c = 0; c < n; c++)
+    {
+        int piv = c;
+        for(int r = c + 1; r < n; r++)
+        {
+            if(std::abs(A[r * n + c]) > std::abs(A[piv * n + c])) piv = r;
+        }
+        if(A[piv * n + c] == 0.0) return false;
+
+        if(piv != c)
+        {
+            for(int k = 0; k < n; k++) std::swap(A[c * n + k], A[piv * n + k]);
+            std::swap(b[c], b[piv]);
+        }
+
+        for(int r = c + 1; r < n; r++)
+        {
+            const Real m = A[r * n + c] / A[c * n + c];
+            for(int k = c; k < n; k++) A[r * n + k] -= m * A[c * n + k];
+            b[r] -= m * b[c];
+        }
+    }
+
+    for(int c = n - 1; c >= 0; c--)
+    {
+        for(int k = c + 1; k < n; k++) b[c] -= A[c * n + k] * b[k];
+        b[c] /= A[c * n + c];
+        if(!std::isfinite(b[c])) return false;
+    }
+    return true;
+}
+
+void AndersonAcceleration::start(const Vector<MultiFab*>& x, const Vector<const MultiFab*>& w)
+{
+    BL_PROFILE("AndersonAcceleration::start()");
+
+    // New grids: the history is of no use
+    if(has_prev && !compatible(f_prev, x))
+    {
+        reset();
+    }
+
+    AMREX_ALWAYS_ASSERT(w.size() == x.size());
+    weight = w;
+
+    define(x_k, x);
+    for(int i = 0; i < int(x.size()); i++)
+    {
+        MultiFab::Copy(*x_k[i], *x[i], 0, 0, x[i]->nComp(), x[i]->nGrow());
+    }
+}
+
+void AndersonAcceleration::accelerate(const Vector<MultiFab*>& x)
+{
+    BL_PROFILE("AndersonAcceleration::accelerate()");
+
+    AMREX_ALWAYS_ASSERT(compatible(x_k, x));
+
+    // Residual f_k = G(x_k) - x_k, in place of x_k
+    State& f = x_k;
+    for(int i = 0; i < int(x.size()); i++)
+    {
+        MultiFab::LinComb(*f[i], 1.0, *x[i], 0, -1.0, *f[i], 0, 0, x[i]->nComp(), x[i]->nGrow());
+    }
+
+    Real fnorm = localDot(f, f);
+    ParallelDescriptor::ReduceRealSum(fnorm);
+    fnorm = std::sqrt(fnorm);
+
+    // The residual has grown too much since the last restart: start over
+    if(f_min >= 0.0 && fnorm > restart_factor * f_min)
+    {
+        if(verbose > 0) amrex::Print() << "Anderson: residual increased, restart" << std::endl;
+        df.clear();
+        dg.clear();
+        f_min = fnorm;
+    }
+    f_min = (f_min < 0.0) ? fnorm : amrex::min(f_min, fnorm);
+
+    // Differences with the previous step, in the storage of the oldest ones if the window is full
+    if(has_prev)
+    {
+        State dfn, dgn;
+        if(int(df.size()) == depth)
+        {
+            dfn = std::move(df.front());
+            dgn = std::move(dg.front());
+            df.pop_front();
+            dg.pop_front();
+        }
+        define(dfn, x);
+        define(dgn, x);
+
+        for(int i = 0; i < int(x.size()); i++)
+        {
+            const int nc = x[i]->nComp();
+            const int ng = x[i]->nGrow();
+            MultiFab::LinComb(*dfn[i], 1.0, *f[i], 0, -1.0, *f_prev[i], 0, 0, nc, ng);
+            MultiFab::LinComb(*dgn[i], 1.0, *x[i], 0, -1.0, *g_prev[i], 0, 0, nc, ng);
+        }
+        df.push_back(std::move(dfn));
+        dg.push_back(std::move(dgn));
+    }
+
+    // Mixing coefficients from the normal equations dF^T dF gamma = dF^T f
+    const int m = df.size();
+    Vector<Real> gamma;
+    if(m > 0)
+    {
+        // All dot products in one reduction: the upper triangle of dF^T dF, then dF^T f
+        Vector<Real> dots;
+        for(int a = 0; a < m; a++)
+        {
+            for(int b = a; b < m; b++) dots.push_back(localDot(df[a], df[b]));
+        }
+        for(int a = 0; a < m; a++) dots.push_back(localDot(df[a], f));
+        ParallelDescriptor::ReduceRealSum(dots.dataPtr(), dots.size());
+
+        Vector<Real> A(m * m);
+        int n = 0;
+        Real diag = 0.0;
+        for(int a = 0; a < m; a++)
+        {
+            for(int b = a; b < m; b++)
+            {
+                A[a * m + b] = A[b * m + a] = dots[n++];
+            }
+            diag = amrex::max(diag, A[a * m + a]);
+        }
+        for(int a = 0; a < m; a++) A[a * m + a] += regularization * diag;
+
+        gamma.assign(dots.begin() + n, dots.end());
+
+        bool ok = (diag > 0.0) && solve(A, gamma, m);
+        for(int a = 0; ok && a < m; a++) ok = std::abs(gamma[a]) <= max_coef;
+
+        if(!ok)
+        {
+            if(verbose > 0) amrex::Print() << "Anderson: ill-conditioned, restart" << std::endl;
+            df.clear();
+            dg.clear();
+            gamma.clear();
+        }
+    }
+
+    // G(x_k) is needed for the next differences
+    define(g_prev, x);
+    for(int i = 0; i < int(x.size()); i++)
+    {
+        MultiFab::Copy(*g_prev[i], *x[i], 0, 0, x[i]->nComp(), x[i]->nGrow());
+    }
+
+    // x_(k+1) = G(x_k) - dG gamma - (1 - relax) (f_k - dF gamma)
+    for(int i = 0; i < int(x.size()); i++)
+    {
+        const int nc = x[i]->nComp();
+        const int ng = x[i]->nGrow();
+
+        for(int a = 0; a < int(gamma.size()); a++)
+        {
+            MultiFab::Saxpy(*x[i], -gamma[a], *dg[a][i], 0, 0, nc, ng);
+        }
+
+        if(relax < 1.0)
+        {
+            MultiFab::Saxpy(*x[i], -(1.0 - relax), *f[i], 0, 0, nc, ng);
+            for(int a = 0; a < int(gamma.size()); a++)
+            {
+                MultiFab::Saxpy(*x[i], (1.0 - relax) * gamma[a], *df[a][i], 0, 0, nc, ng);
+            }
+        }
+    }
+
+    if(verbose > 0)
+    {
+        Real gmax = 0.0;
+        for(Real g : gamma) gmax = amrex::max(gmax, std::abs(g));
+        amrex::Print() << "Anderson: depth = " << gamma.size() << ", |f| = " << fnorm
+                       << ", max |gamma| = " << gmax << std::endl;
+    }
+
+    // f_k becomes the previous residual, the storage of the previous one is reused by start()
+    std::swap(x_k, f_prev);
+    has_prev = true;
+}
@@ -0,0 +1,342 @@
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Vector.H>
+
+#include <PhaseTimer.H>
+
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+namespace
+{
+    struct TimerNode
+    {
+        const char* name;
+        int parent;
+        Vector<int> children;
+
+        Real t_start = 0.0;
+        Real t_interval = 0.0;  // Time since the last JSON record
+        Real t_total = 0.0;     // Time since the start of the run
+        long calls = 0;
+    };
+
+    // Node 0 is the root of the tree, it is never timed itself
+    Vector<TimerNode> nodes{TimerNode{"incflo", -1, {}}};
+    int current = 0;
+
+    // Names of the nodes only known from other ranks (a deque keeps the pointers valid)
+    std::deque<std::string> remote_names;
+
+    bool enabled = true;
+    bool print_summary = true;
+    int report_int = -1;
+    std::string report_file{"timers.json"};
+
+    // Work done since the last record / since the start of the run
+    long interval_cells = 0;
+    long total_cells = 0;
+    Real interval_start = -1.0;
+
+    bool in_parallel_region()
+    {
+#ifdef _OPENMP
+        return omp_in_parallel();
+#else
+        return false;
+#endif
+    }
+
+    // Child of parent with this name, made if it doesn't exist yet. Names are usually string
+    // literals, so comparing the pointers first catches most cases.
+    int find_or_add(int parent, const char* name)
+    {
+        for(int child : nodes[parent].children)
+        {
+            if(nodes[child].name == name || std::strcmp(nodes[child].name, name) == 0)
+            {
+                return child;
+            }
+        }
+
+        int node = nodes.size();
+        nodes.push_back(TimerNode{name, parent, {}});
+        nodes[parent].children.push_back(node);
+        return node;
+    }
+
+    // Path of a node below the root, e.g. "Advance/ApplyPredictor"
+    std::string node_path(int n)
+    {
+        const int parent = nodes[n].parent;
+        return parent == 0 ? std::string(nodes[n].name) : node_path(parent) + "/" + nodes[n].name;
+    }
+
+    // Node with the given path, made (with its parents) if it doesn't exist on this rank
+    int node_at(const std::string& path)
+    {
+        int node = 0;
+        std::istringstream is(path);
+        std::string name;
+        while(std::getline(is, name, '/'))
+        {
+            // Look the name up first, so that known names keep their storage
+            int child = -1;
+            for(int c : nodes[node].children)
+            {
+                if(name == nodes[c].name) child = c;
+            }
+            if(child < 0)
+            {
+                remote_names.push_back(name);
+                child = find_or_add(node, remote_names.back().c_str());
+            }
+            node = child;
+        }
+        return node;
+    }
+
+    //
+    // Ranks don't necessarily time the same phases (e.g. those only run on tiles with EB), so
+    // their trees may differ. Give every rank the nodes of all ranks (with zero time where it
+    // didn't run them) and return all nodes in an order common to all ranks, root first.
+    //
+    Vector<int> common_order()
+    {
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+        // Paths of the local nodes, one per line. Parents come before their children.
+        std::string local;
+        for(int n = 1; n < nodes.size(); n++) local += node_path(n) + "\n";
+
+        // Gather them on the IO processor, padded to the longest one
+        int len = local.size();
+        int maxlen = len;
+        ParallelDescriptor::ReduceIntMax(maxlen);
+
+        Vector<int> lens(nprocs, 0);
+        ParallelDescriptor::Gather(&len, 1, lens.dataPtr(), ioproc);
+
+        Vector<char> send(maxlen + 1, '\0');
+        std::copy(local.begin(), local.end(), send.begin());
+        Vector<char> recv(ParallelDescriptor::IOProcessor() ? (maxlen + 1) * nprocs : 1);
+        ParallelDescriptor::Gather(send.dataPtr(), maxlen + 1, recv.dataPtr(), ioproc);
+
+        // Union of the paths, in the order they are first seen
+        std::string merged;
+        if(ParallelDescriptor::IOProcessor())
+        {
+            std::set<std::string> seen;
+            for(int r = 0; r < nprocs; r++)
+            {
+                std::istringstream is(std::string(&recv[r * (maxlen + 1)], lens[r]));
+                std::string path;
+                while(std::getline(is, path))
+                {
+                    if(seen.insert(path).second) merged += path + "\n";
+                }
+            }
+        }
+
+        int mlen = merged.size();
+        ParallelDescriptor::Bcast(&mlen, 1, ioproc);
+        Vector<char> mbuf(merged.begin(), merged.end());
+        mbuf.resize(mlen + 1, '\0');
+        ParallelDescriptor::Bcast(mbuf.dataPtr(), mlen + 1, ioproc);
+
+        Vector<int> order{0};
+        std::istringstream is(std::string(mbuf.dataPtr(), mlen));
+        std::string path;
+        while(std::getline(is, path))
+        {
+            order.push_back(node_at(path));
+        }
+        return order;
+    }
+
+    // Reduce the interval or total times of all nodes over all ranks onto the IO processor.
+    // The results are indexed by node.
+    void reduce_times(bool total, Vector<Real>& tmin, Vector<Real>& tavg, Vector<Real>& tmax)
+    {
+        const int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+        const Vector<int> order = common_order();
+
+        Vector<Real> t(order.size());
+        for(int i = 0; i < order.size(); i++)
+        {
+            const TimerNode& node = nodes[order[i]];
+            t[i] = total ? node.t_total : node.t_interval;
+        }
+
+        Vector<Real> rmin(t), rsum(t), rmax(t);
+        ParallelDescriptor::ReduceRealMin(rmin.dataPtr(), rmin.size(), ioproc);
+        ParallelDescriptor::ReduceRealSum(rsum.dataPtr(), rsum.size(), ioproc);
+        ParallelDescriptor::ReduceRealMax(rmax.dataPtr(), rmax.size(), ioproc);
+
+        tmin.assign(nodes.size(), 0.0);
+        tavg.assign(nodes.size(), 0.0);
+        tmax.assign(nodes.size(), 0.0);
+        for(int i = 0; i < order.size(); i++)
+        {
+            tmin[order[i]] = rmin[i];
+            tavg[order[i]] = rsum[i] / ParallelDescriptor::NProcs();
+            tmax[order[i]] = rmax[i];
+        }
+    }
+
+    void write_json(std::ostream& os, int n,
+                    const Vector<Real>& tmin, const Vector<Real>& tavg, const Vector<Real>& tmax)
+    {
+        os << "{\"min\":" << tmin[n] << ",\"avg\":" << tavg[n] << ",\"max\":" << tmax[n];
+        if(!nodes[n].children.empty())
+        {
+            os << ",\"children\":{";
+            for(int c = 0; c < nodes[n].children.size(); c++)
+            {
+                int child = nodes[n].children[c];
+                if(c > 0) os << ",";
+                os << "\"" << nodes[child].name << "\":";
+                write_json(os, child, tmin, tavg, tmax);
+            }
+            os << "}";
+        }
+        os << "}";
+    }
+
+    void print_tree(int n, int depth, Real run_time,
+                    const Vector<Real>& tmin, const Vector<Real>& tavg, const Vector<Real>& tmax)
+    {
+        std::string label = std::string(2 * depth, ' ') + nodes[n].name;
+        amrex::Print() << std::left << std::setw(40) << label << std::right
+                       << std::setw(10) << nodes[n].calls
+                       << std::setw(14) << tmin[n]
+                       << std::setw(14) << tavg[n]
+                       << std::setw(14) << tmax[n]
+                       << std::setw(9) << std::setprecision(3) << std::fixed
+                       << (run_time > 0.0 ? 100.0 * tmax[n] / run_time : 0.0)
+                       << std::defaultfloat << std::setprecision(6) << "\n";
+        for(int child : nodes[n].children)
+        {
+            print_tree(child, depth + 1, run_time, tmin, tavg, tmax);
+        }
+    }
+}
+
+void PhaseTimer::readParameters()
+{
+    ParmParse pp("timer");
+
+    int enable = enabled;
+    int summary = print_summary;
+    pp.query("enable", enable);
+    pp.query("summary", summary);
+    pp.query("report_int", report_int);
+    pp.query("report_file", report_file);
+
+    enabled = enable;
+    print_summary = summary;
+}
+
+void PhaseTimer::start(const char* name)
+{
+    if(!enabled || in_parallel_region()) return;
+
+    current = find_or_add(current, name);
+    nodes[current].t_start = ParallelDescriptor::second();
+
+    // The first JSON record covers everything since the first timed phase
+    if(interval_start < 0.0) interval_start = nodes[current].t_start;
+}
+
+void PhaseTimer::stop()
+{
+    if(!enabled || in_parallel_region() || current == 0) return;
+
+    TimerNode& node = nodes[current];
+    Real elapsed = ParallelDescriptor::second() - node.t_start;
+    node.t_interval += elapsed;
+    node.t_total += elapsed;
+    node.calls++;
+
+    current = node.parent;
+}
+
+void PhaseTimer::endStep(int nstep, Real time, long ncells)
+{
+    if(!enabled) return;
+
+    interval_cells += ncells;
+    total_cells += ncells;
+
+    if(report_int <= 0 || nstep % report_int != 0) return;
+
+    // The time of the whole interval goes in the root node
+    nodes[0].t_interval = ParallelDescriptor::second() - interval_start;
+
+    Vector<Real> tmin, tavg, tmax;
+    reduce_times(false, tmin, tavg, tmax);
+
+    if(ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream File(report_file.c_str(), std::ofstream::out | std::ofstream::app);
+        if(!File.good())
+            amrex::FileOpenFailed(report_file);
+
+        File.precision(6);
+        File << "{\"step\":" << nstep
+             << ",\"time\":" << time
+             << ",\"nprocs\":" << ParallelDescriptor::NProcs()
+             << ",\"cell_updates\":" << interval_cells
+             << ",\"cell_updates_per_sec\":"
+             << (tmax[0] > 0.0 ? interval_cells / tmax[0] : 0.0)
+             << ",\"phases\":";
+        write_json(File, 0, tmin, tavg, tmax);
+        File << "}\n";
+    }
+
+    for(TimerNode& node : nodes) node.t_interval = 0.0;
+    interval_cells = 0;
+    interval_start = ParallelDescriptor::second();
+}
+
+void PhaseTimer::summary(Real run_time)
+{
+    if(!enabled || !print_summary) return;
+
+    nodes[0].t_total = run_time;
+    nodes[0].calls = 1;
+
+    Vector<Real> tmin, tavg, tmax;
+    reduce_times(true, tmin, tavg, tmax);
+
+    amrex::Print() << "\nPhase timers (seconds, over " << ParallelDescriptor::NProcs() << " ranks):\n"
+                   << std::left << std::setw(40) << "phase" << std::right
+                   << std::setw(10) << "calls"
+                   << std::setw(14) << "min"
+                   << std::setw(14) << "avg"
+                   << std::setw(14) << "max"
+                   << std::setw(9) << "%" << "\n";
+    print_tree(0, 0, tmax[0], tmin, tavg, tmax);
+
+    if(tmax[0] > 0.0)
+    {
+        amrex::Print() << "Cell updates: " << total_cells
+                       << ", cell updates per second: " << total_cells / tmax[0]
+                       << " (" << total_cells / tmax[0] / ParallelDescriptor::NProcs()
+                       << " per rank)\n" << std::endl;
+    }
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#include <ScratchPool.H>
+
+using namespace amrex;
+
+std::unique_ptr<MultiFab> ScratchPool::acquire(const BoxArray& ba,
+                                               const DistributionMapping& dm,
+                                               int ncomp, int ngrow,
+                                               const FabFactory<FArrayBox>& factory)
+{
+    if(enabled)
+    {
+        for(auto& e : entries)
+        {
+            // Cheap comparisons first, BoxArray and DistributionMapping compare their
+            // references before the boxes and processor maps
+            if(e.mf && e.ncomp == ncomp && e.ngrow == ngrow && e.factory == &factory &&
+               e.ba == ba && e.dm == dm)
+            {
+                hits++;
+                return std::move(e.mf);
+            }
+        }
+    }
+
+    misses++;
+
+    std::unique_ptr<MultiFab> mf(new MultiFab(ba, dm, ncomp, ngrow, MFInfo(), factory));
+
+    long nbytes = 0;
+    for(MFIter mfi(*mf); mfi.isValid(); ++mfi)
+    {
+        nbytes += (*mf)[mfi].nBytes();
+    }
+
+    Entry e;
+    e.ba = ba;
+    e.dm = dm;
+    e.ncomp = ncomp;
+    e.ngrow = ngrow;
+    e.factory = &factory;
+    e.mf_ptr = mf.get();
+    e.bytes = nbytes;
+    entries.push_back(std::move(e));
+
+    bytes += nbytes;
+    peak_bytes = std::max(peak_bytes, bytes);
+
+    return mf;
+}
+
+void ScratchPool::release(std::unique_ptr<MultiFab>&& mf)
+{
+    if(!mf) return;
+
+    for(auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if(!it->mf && it->mf_ptr == mf.get())
+        {
+            if(enabled)
+            {
+                it->mf = std::move(mf);
+            }
+            else
+            {
+                bytes -= it->bytes;
+                entries.erase(it);
+                mf.reset();
+            }
+            return;
+        }
+    }
+
+    amrex::Abort("ScratchPool::release(): MultiFab was not acquired from this pool");
+}
+
+void ScratchPool::release(Vector<std::unique_ptr<MultiFab>>& mf)
+{
+    for(auto& level_mf : mf)
+    {
+        release(std::move(level_mf));
+        level_mf.reset();
+    }
+}
+
+void ScratchPool::clear()
+{
+    for(const auto& e : entries)
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(e.mf != nullptr,
+                "ScratchPool::clear(): a buffer is still in use");
+    }
+
+    entries.clear();
+    bytes = 0;
+}
+
+void ScratchPool::printStatistics() const
+{
+    long peak = peak_bytes;
+    ParallelDescriptor::ReduceLongMax(peak, ParallelDescriptor::IOProcessorNumber());
+
+    long requests = hits + misses;
+    amrex::Print() << "Scratch pool: " << requests << " requests, "
+                   << hits << " hits, " << misses << " misses ("
+                   << (requests > 0 ? 100.0 * hits / requests : 0.0) << "% reuse), "
+                   << "peak " << peak / (1024.0 * 1024.0) << " MB per rank" << std::endl;
+}
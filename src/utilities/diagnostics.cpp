@@ -11,45 +11,50 @@ Real incflo::Norm(const Vector<std::unique_ptr<MultiFab>>& mf, int lev, int comp
     // Make copy of MF so that we can set values in covered cells to zero. 
     int ncomp = 1;
     int ngrow = 0;
-    MultiFab mf_tmp(mf[lev]->boxArray(), mf[lev]->DistributionMap(), ncomp, ngrow, 
-                    MFInfo(), *ebfactory[lev]);
+    std::unique_ptr<MultiFab> mf_tmp = scratch.acquire(mf[lev]->boxArray(), mf[lev]->DistributionMap(),
+                                                       ncomp, ngrow, *ebfactory[lev]);
 
-	MultiFab::Copy(mf_tmp, *mf[lev], comp, 0, 1, 0);
-	EB_set_covered(mf_tmp, 0.0);
+	MultiFab::Copy(*mf_tmp, *mf[lev], comp, 0, 1, 0);
+	EB_set_covered(*mf_tmp, 0.0);
 
+    Real norm;
     if(norm_type == 0)
     {
-        return mf_tmp.norm0(0);
+        norm = mf_tmp->norm0(0);
     }
     else if(norm_type == 1)
     {
-        return mf_tmp.norm1(0, geom[lev].periodicity());
+        norm = mf_tmp->norm1(0, geom[lev].periodicity());
     }
     else
     {
         amrex::Print() << "Warning: called incflo::Norm() with norm_type not in {0,1}" << std::endl; 
-        return -1.0;
+        norm = -1.0;
     }
+
+    scratch.release(std::move(mf_tmp));
+    return norm;
 }
 
 // 
 // Print maximum values (useful for tracking evolution)
 void incflo::PrintMaxValues(Real time)
 {
-        ComputeDivU(time);
+        Vector<std::unique_ptr<MultiFab>> divu = ComputeDivU(time);
         for(int lev = 0; lev <= finest_level; lev++)
         {
             amrex::Print() << "Level " << lev << std::endl; 
-            PrintMaxVel(lev);
+            PrintMaxVel(lev, divu);
             PrintMaxGp(lev);
         }
         amrex::Print() << std::endl; 
+        scratch.release(divu);
 }
 
 //
 // Print the maximum values of the velocity components and velocity divergence
 //
-void incflo::PrintMaxVel(int lev)
+void incflo::PrintMaxVel(int lev, const Vector<std::unique_ptr<MultiFab>>& divu)
 {
 	amrex::Print() << "max(abs(u/v/w/divu))  = "
                    << Norm(vel, lev, 0, 0) << "  "
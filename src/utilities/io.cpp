@@ -2,6 +2,7 @@
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_Utility.H>
 #include <AMReX_buildInfo.H>
 
 #include <incflo.H>
@@ -66,6 +67,7 @@ void incflo::WriteHeader(
 void incflo::WriteCheckPointFile() const
 {
 	BL_PROFILE("incflo::WriteCheckPointFile()");
+	INCFLO_TIMER("WriteCheckPointFile");
 
 	const std::string& checkpointname = amrex::Concatenate(check_file, nstep);
 
@@ -97,7 +99,27 @@ void incflo::WriteCheckPointFile() const
 						 amrex::MultiFabFileFullPrefix(
 							 lev, checkpointname, level_prefix, chkscaVarsName[i]));
 		}
+
+        // Running statistics, so that averaging continues after a restart
+        if(stats[lev])
+        {
+            VisMF::Write(*stats[lev],
+                         amrex::MultiFabFileFullPrefix(lev, checkpointname, level_prefix, "stats"));
+        }
 	}
+
+    // The averaging times are kept out of the main Header to leave its format unchanged
+    if(stats_start_time >= 0.0 && ParallelDescriptor::IOProcessor())
+    {
+        std::string StatsFileName(checkpointname + "/StatsHeader");
+        std::ofstream StatsFile(StatsFileName.c_str(), std::ofstream::out | std::ofstream::trunc);
+        if(!StatsFile.good())
+            amrex::FileOpenFailed(StatsFileName);
+
+        StatsFile.precision(17);
+        StatsFile << stats_time << "\n";
+        StatsFile << stats_last_time << "\n";
+    }
 }
 
 void incflo::ReadCheckpointFile()
@@ -184,6 +206,31 @@ void incflo::ReadCheckpointFile()
         ba.readFrom(is);
         GotoNextLine(is);
 
+        // Optionally regenerate the grids for the current max_grid_size and number of ranks.
+        // The checkpoint data is then copied onto the new layout below.
+        if(regrid_on_restart)
+        {
+            if(lev == 0)
+            {
+                ba = MakeBaseGrids();
+            }
+            else
+            {
+                // Keep the refined region, but merge and re-chop its boxes. The chopping is done
+                // in units of the blocking factor, so that the new boxes still respect it.
+                const IntVect& bf = blocking_factor[lev];
+
+                BoxList bl(ba);
+                bl.simplify();
+                ba = BoxArray(bl);
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ba.coarsenable(bf),
+                        "Regrid on restart: the checkpoint grids don't respect amr.blocking_factor");
+                ba.coarsen(bf);
+                ba.maxSize(max_grid_size[lev] / bf);
+                ba.refine(bf);
+            }
+        }
+
         // Create distribution mapping
         DistributionMapping dm{ba, ParallelDescriptor::NProcs()};
 
@@ -194,7 +241,8 @@ void incflo::ReadCheckpointFile()
      * Load fluid data                                                         *
      ***************************************************************************/
 
-	// Load the field data
+	// Load the field data. Note that copy() also redistributes the data in case the grids
+	// have been regenerated above.
 	for(int lev = 0; lev <= finest_level; ++lev)
 	{
 		// Read velocity and pressure gradients
@@ -225,6 +273,27 @@ void incflo::ReadCheckpointFile()
 		}
 	}
 
+    // Load running statistics if the checkpoint has them
+    if(stats_start_time >= 0.0 && amrex::FileExists(restart_file + "/StatsHeader"))
+    {
+        Vector<char> statsCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(restart_file + "/StatsHeader", statsCharPtr);
+        std::istringstream sis(std::string(statsCharPtr.dataPtr()), std::istringstream::in);
+
+        sis >> stats_time;
+        GotoNextLine(sis);
+        sis >> stats_last_time;
+
+        for(int lev = 0; lev <= finest_level; ++lev)
+        {
+            MultiFab mf_stats;
+            VisMF::Read(mf_stats, MultiFabFileFullPrefix(lev, restart_file, level_prefix, "stats"));
+            stats[lev]->copy(mf_stats, 0, 0, NumStatistics(), 0, 0);
+        }
+
+        amrex::Print() << "Continuing statistics averaged over " << stats_time << std::endl;
+    }
+
 	amrex::Print() << "Restart complete" << std::endl;
 }
 
@@ -315,189 +384,250 @@ void incflo::WriteJobInfo(const std::string& path) const
 	}
 }
 
-void incflo::WritePlotFile() const
+void incflo::WritePlotFile()
 {
-
 	BL_PROFILE("incflo::WritePlotFile()");
+	INCFLO_TIMER("WritePlotFile");
 
 	const std::string& plotfilename = amrex::Concatenate(plot_file, nstep);
 
 	amrex::Print() << "  Writing plotfile " << plotfilename << std::endl;
 
-	const int ngrow = 0;
+    // Name of the MultiFab holding the plot data on each level
+    const std::string mf_prefix{"Cell"};
+
+    Vector<std::string> pltscaVarsName;
+
+    // First just set all of the names once (not once per level)
+
+    // Velocity components
+    if (plt_vel == 1)
+    {
+        pltscaVarsName.push_back("velx");
+        pltscaVarsName.push_back("vely");
+        pltscaVarsName.push_back("velz");
+    }
+
+    // Pressure gradient components
+    if (plt_gradp == 1)
+    {
+        pltscaVarsName.push_back("gpx");
+        pltscaVarsName.push_back("gpy");
+        pltscaVarsName.push_back("gpz");
+    }
+
+    // Density
+    if(plt_rho == 1) 
+        pltscaVarsName.push_back("ro");
+
+    // Pressure
+    if(plt_p == 1)
+        pltscaVarsName.push_back("p");
+
+    // Apparent viscosity
+    if(plt_eta == 1) 
+        pltscaVarsName.push_back("eta");
 
-	Vector<std::unique_ptr<MultiFab>> mf(finest_level + 1);
+    // Vorticity
+    if(plt_vort == 1) 
+        pltscaVarsName.push_back("vort");
 
-        Vector<std::string> pltscaVarsName;
+    // Magnitude of the rate-of-strain tensor 
+    if(plt_strainrate == 1) 
+        pltscaVarsName.push_back("strainrate");
 
-        // First just set all of the names once (not once per level)
+    // Magnitude of the stress tensor 
+    if(plt_stress == 1) 
+        pltscaVarsName.push_back("stress");
+
+    // Divergence of velocity field
+    if(plt_divu == 1) 
+        pltscaVarsName.push_back("divu");
+
+    // Cut cell volume fraction
+    if(plt_vfrac == 1) 
+        pltscaVarsName.push_back("vfrac");
+
+    // Switch the FAB output format to 32-bit floats if requested; the previous
+    // settings are restored once the plotfile has been written.
+    const FABio::Format fab_format = FArrayBox::getFormat();
+    const VisMF::Header::Version vismf_version = VisMF::GetHeaderVersion();
+    if(plot_single_precision)
+    {
+        // Only the v1 header (one FAB header per box) records the on-disk precision
+        VisMF::SetHeaderVersion(VisMF::Header::Version_v1);
+        FArrayBox::setFormat(FABio::FAB_NATIVE_32);
+    }
+
+    amrex::PreBuildDirectorHierarchy(plotfilename, level_prefix, finest_level + 1, true);
+
+    // This needs to be defined in order to write the plotfile header,
+    // but will never change unless we use subcycling. 
+    // If we do use subcycling, this should be a incflo class member. 
+    Vector<int> istep(finest_level + 1, 1);
+
+    // The header only needs the BoxArrays, so it can be written before any data is filled
+    if(ParallelDescriptor::IOProcessor())
+    {
+        std::string HeaderFileName(plotfilename + "/Header");
+        VisMF::IO_Buffer io_buffer(VisMF::IO_Buffer_Size);
+        std::ofstream HeaderFile;
+
+        HeaderFile.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+
+        HeaderFile.open(HeaderFileName.c_str(),
+                        std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+        if(!HeaderFile.good())
+            amrex::FileOpenFailed(HeaderFileName);
+
+        Vector<BoxArray> plt_grids(grids.begin(), grids.begin() + finest_level + 1);
+
+        amrex::WriteGenericPlotfileHeader(HeaderFile, finest_level + 1, plt_grids,
+                                          pltscaVarsName, Geom(), cur_time, istep, refRatio(),
+                                          "HyperCLaw-V1.1", level_prefix, mf_prefix);
+    }
+
+    // The vorticity and divergence are only computed when they are plotted
+    Vector<std::unique_ptr<MultiFab>> vort;
+    Vector<std::unique_ptr<MultiFab>> divu;
+    if(plt_vort == 1) vort = ComputeVorticity();
+    if(plt_divu == 1) divu = ComputeDivU(cur_time);
+
+    // Now fill and write the data one level at a time, so that only a single level's
+    // worth of plot variables is ever allocated
+	for(int lev = 0; lev <= finest_level; ++lev)
+	{
+        MultiFab mf(grids[lev], dmap[lev], pltVarCount, 0, MFInfo(), *ebfactory[lev]);
+
+        int lc = 0;
 
         // Velocity components
-        if (plt_vel == 1)
+        if(plt_vel == 1)
         {
-            pltscaVarsName.push_back("velx");
-            pltscaVarsName.push_back("vely");
-            pltscaVarsName.push_back("velz");
+            MultiFab::Copy(mf, (*vel[lev]), 0, lc, AMREX_SPACEDIM, 0);
+
+            lc += AMREX_SPACEDIM;
         }
 
         // Pressure gradient components
-        if (plt_gradp == 1)
+        if(plt_gradp == 1)
         {
-            pltscaVarsName.push_back("gpx");
-            pltscaVarsName.push_back("gpy");
-            pltscaVarsName.push_back("gpz");
+            MultiFab::Copy(mf, (*gp[lev]), 0, lc, AMREX_SPACEDIM, 0);
+
+            lc += AMREX_SPACEDIM;
         }
 
         // Density
         if(plt_rho == 1) 
-            pltscaVarsName.push_back("ro");
+        {
+            MultiFab::Copy(mf, (*ro[lev]), 0, lc, 1, 0);
+
+            lc += 1;
+        }
 
-        // Pressure
+        // Pressure: average the nodal values of p + p0 to cell centres directly,
+        // without going through a nodal temporary
         if(plt_p == 1)
-            pltscaVarsName.push_back("p");
+        {
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for(MFIter mfi(mf, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+
+                const auto& mf_arr = mf.array(mfi);
+                const auto&  p_arr = p[lev]->array(mfi);
+                const auto& p0_arr = p0[lev]->array(mfi);
+
+                const int pc = lc;
+
+                AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+                {
+                    mf_arr(i,j,k,pc) = 0.125 * ( p_arr(i  ,j  ,k  ) + p0_arr(i  ,j  ,k  )
+                                               + p_arr(i+1,j  ,k  ) + p0_arr(i+1,j  ,k  )
+                                               + p_arr(i  ,j+1,k  ) + p0_arr(i  ,j+1,k  )
+                                               + p_arr(i+1,j+1,k  ) + p0_arr(i+1,j+1,k  )
+                                               + p_arr(i  ,j  ,k+1) + p0_arr(i  ,j  ,k+1)
+                                               + p_arr(i+1,j  ,k+1) + p0_arr(i+1,j  ,k+1)
+                                               + p_arr(i  ,j+1,k+1) + p0_arr(i  ,j+1,k+1)
+                                               + p_arr(i+1,j+1,k+1) + p0_arr(i+1,j+1,k+1) );
+                });
+            }
+
+            lc += 1;
+        }
 
         // Apparent viscosity
         if(plt_eta == 1) 
-            pltscaVarsName.push_back("eta");
+        {
+            MultiFab::Copy(mf, (*eta[lev]), 0, lc, 1, 0);
+
+            lc += 1;
+        }
 
         // Vorticity
         if(plt_vort == 1) 
-            pltscaVarsName.push_back("vort");
+        {
+            MultiFab::Copy(mf, (*vort[lev]), 0, lc, 1, 0);
+
+            lc += 1;
+        }
 
         // Magnitude of the rate-of-strain tensor 
         if(plt_strainrate == 1) 
-            pltscaVarsName.push_back("strainrate");
+        {
+            MultiFab::Copy(mf, (*strainrate[lev]), 0, lc, 1, 0);
+
+            lc += 1;
+        }
 
         // Magnitude of the stress tensor 
         if(plt_stress == 1) 
-            pltscaVarsName.push_back("stress");
+        {
+            MultiFab::Copy(mf, (*strainrate[lev]), 0, lc, 1, 0);
+            MultiFab::Multiply(mf, (*eta[lev]), 0, lc, 1, 0);
+
+            lc += 1;
+        }
 
         // Divergence of velocity field
         if(plt_divu == 1) 
-            pltscaVarsName.push_back("divu");
+        {
+            MultiFab::Copy(mf, (*divu[lev]), 0, lc, 1, 0);
+
+            lc += 1;
+        }
 
         // Cut cell volume fraction
         if(plt_vfrac == 1) 
-            pltscaVarsName.push_back("vfrac");
-
-        // Now fill the data at every level
-
-	for(int lev = 0; lev <= finest_level; ++lev)
-	{
-            // Multifab to hold all the variables -- there can be only one!!!!
-    	    const int ncomp = pltVarCount;
-	    mf[lev].reset(new MultiFab(grids[lev], dmap[lev], ncomp, ngrow, MFInfo(), *ebfactory[lev]));
-
-            int lc = 0;
-
-            // Velocity components
-            if(plt_vel == 1)
-            {
-                MultiFab::Copy(*mf[lev], (*vel[lev]), 0, lc  , 1, 0);
-                MultiFab::Copy(*mf[lev], (*vel[lev]), 1, lc+1, 1, 0);
-                MultiFab::Copy(*mf[lev], (*vel[lev]), 2, lc+2, 1, 0);
-
-                lc += AMREX_SPACEDIM;
-            }
-
-            // Pressure gradient components
-            if(plt_gradp == 1)
-            {
-                MultiFab::Copy(*mf[lev], (*gp[lev]), 0, lc  , 1, 0);
-                MultiFab::Copy(*mf[lev], (*gp[lev]), 1, lc+1, 1, 0);
-                MultiFab::Copy(*mf[lev], (*gp[lev]), 2, lc+2, 1, 0);
-    
-                lc += AMREX_SPACEDIM;
-            }
-
-            // Density
-            if(plt_rho == 1) 
-            {
-                MultiFab::Copy(*mf[lev], (*ro[lev]), 0, lc, 1, 0);
-    
-                lc += 1;
-            }
-
-            // Pressure
-            if(plt_p == 1)
-            {
-                MultiFab p_nd(p[lev]->boxArray(), dmap[lev], 1, 0);
-                p_nd.setVal(0.0);
-                MultiFab::Copy(p_nd, (*p[lev]), 0, 0, 1, 0);
-                MultiFab::Add(p_nd, (*p0[lev]), 0, 0, 1, 0);
-                amrex::average_node_to_cellcenter(*mf[lev], lc, p_nd, 0, 1);
-    
-                lc += 1;
-            }
-
-            // Apparent viscosity
-            if(plt_eta == 1) 
-            {
-                MultiFab::Copy(*mf[lev], (*eta[lev]), 0, lc, 1, 0);
-    
-                lc += 1;
-            }
-
-            // Vorticity
-            if(plt_vort == 1) 
-            {
-                MultiFab::Copy(*mf[lev], (*vort[lev]), 0, lc, 1, 0);
-    
-                lc += 1;
-            }
-
-            // Magnitude of the rate-of-strain tensor 
-            if(plt_strainrate == 1) 
-            {
-                MultiFab::Copy(*mf[lev], (*strainrate[lev]), 0, lc, 1, 0);
-    
-                lc += 1;
-            }
-
-            // Magnitude of the stress tensor 
-            if(plt_stress == 1) 
+        {
+            if (ebfactory[lev]) 
             {
-                MultiFab::Copy(*mf[lev], (*strainrate[lev]), 0, lc, 1, 0);
-                MultiFab::Multiply(*mf[lev], (*eta[lev]), 0, lc, 1, 0);
-
-                lc += 1;
+                MultiFab::Copy(mf, ebfactory[lev]->getVolFrac(), 0, lc, 1, 0);
             }
-    
-            // Divergence of velocity field
-            if(plt_divu == 1) 
+            else
             {
-                MultiFab::Copy(*mf[lev], (*divu[lev]), 0, lc, 1, 0);
-    
-                lc += 1;
+                mf.setVal(1.0, lc, 1, 0);
             }
 
-            // Cut cell volume fractino
-            if(plt_vfrac == 1) 
-            {
-                if (ebfactory[lev]) 
-                {
-                    MultiFab::Copy(*mf[lev], ebfactory[lev]->getVolFrac(), 0, lc, 1, 0);
-                }
-                else
-                {
-                    mf[lev]->setVal(1.0, lc, 1.0);
-                }
+            lc += 1;
+        }
 
-                lc += 1;
-            }
+        // Zero out all the values in covered cells
+        EB_set_covered(mf, 0.0);
 
-            // Zero out all the values in covered cells
-            EB_set_covered(*mf[lev], 0.0);
-        }
+        // Write this level, its buffer is freed before moving on to the next one
+        VisMF::Write(mf, amrex::MultiFabFileFullPrefix(lev, plotfilename, level_prefix, mf_prefix));
+    }
 
-        // This needs to be defined in order to use amrex::WriteMultiLevelPlotfile, 
-        // but will never change unless we use subcycling. 
-        // If we do use subcycling, this should be a incflo class member. 
-        Vector<int> istep(finest_level + 1, 1);
+    scratch.release(vort);
+    scratch.release(divu);
 
-        // Write the plotfile
-        amrex::WriteMultiLevelPlotfile(plotfilename, finest_level + 1, GetVecOfConstPtrs(mf), 
-                                   pltscaVarsName, Geom(), cur_time, istep, refRatio());
+    // Restore the default output format
+    FArrayBox::setFormat(fab_format);
+    VisMF::SetHeaderVersion(vismf_version);
 
 	WriteJobInfo(plotfilename);
 }
@@ -0,0 +1,216 @@
+#include <AMReX_EBMultiFabUtil.H>
+#include <AMReX_PlotFileUtil.H>
+
+#include <incflo.H>
+
+namespace
+{
+    // Components of the statistics MultiFab: running time averages of
+    // the primary quantities followed by the averages of their products
+    enum StatsComp
+    {
+        s_u = 0, s_v, s_w, s_p, s_eta,
+        s_uu, s_vv, s_ww, s_uv, s_uw, s_vw, s_pp, s_etaeta,
+        s_ncomp
+    };
+}
+
+int incflo::NumStatistics() const
+{
+    return s_ncomp;
+}
+
+//
+// Update the running time averages with the current solution:
+//
+//      <q>_new = <q>_old + w / T_new * (q - <q>_old)
+//
+// where w is the time elapsed since the previous sample (for the first sample, since
+// stats.start_time) and T_new the total averaging time including this sample. The same update is applied to the products u_i u_j, p p and eta eta,
+// so that the fluctuations follow as e.g. <u'v'> = <uv> - <u><v>.
+//
+void incflo::AccumulateStatistics()
+{
+    BL_PROFILE("incflo::AccumulateStatistics()");
+    INCFLO_TIMER("AccumulateStatistics");
+
+    // The first sample represents all the time since averaging started, which is more than the
+    // last step if stats.int > 1 or stats.start_time fell inside a step
+    Real weight = cur_time - ((stats_time > 0.0) ? stats_last_time : stats_start_time);
+    stats_last_time = cur_time;
+    if(weight <= 0.0) return;
+
+    stats_time += weight;
+    const Real f = weight / stats_time;
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        const auto& flags = ebfactory[lev]->getMultiEBCellFlagFab();
+        const EBTiles& tiles = GetEBTiles(lev);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*stats[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+
+            if(tiles.type(mfi, 0) == FabType::covered) continue;
+
+            const auto& st_arr   = stats[lev]->array(mfi);
+            const auto& vel_arr  =   vel[lev]->array(mfi);
+            const auto& eta_arr  =   eta[lev]->array(mfi);
+            const auto& p_arr    =     p[lev]->array(mfi);
+            const auto& p0_arr   =    p0[lev]->array(mfi);
+            const auto& flag_arr = flags[mfi].array();
+
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+            {
+                if(!flag_arr(i,j,k).isCovered())
+                {
+                    Real u = vel_arr(i,j,k,0);
+                    Real v = vel_arr(i,j,k,1);
+                    Real w = vel_arr(i,j,k,2);
+                    Real e = eta_arr(i,j,k);
+
+                    // Cell-centred value of the nodal pressure p + p0
+                    Real pc = 0.125 * ( p_arr(i  ,j  ,k  ) + p0_arr(i  ,j  ,k  )
+                                      + p_arr(i+1,j  ,k  ) + p0_arr(i+1,j  ,k  )
+                                      + p_arr(i  ,j+1,k  ) + p0_arr(i  ,j+1,k  )
+                                      + p_arr(i+1,j+1,k  ) + p0_arr(i+1,j+1,k  )
+                                      + p_arr(i  ,j  ,k+1) + p0_arr(i  ,j  ,k+1)
+                                      + p_arr(i+1,j  ,k+1) + p0_arr(i+1,j  ,k+1)
+                                      + p_arr(i  ,j+1,k+1) + p0_arr(i  ,j+1,k+1)
+                                      + p_arr(i+1,j+1,k+1) + p0_arr(i+1,j+1,k+1) );
+
+                    st_arr(i,j,k,s_u)      += f * (u      - st_arr(i,j,k,s_u));
+                    st_arr(i,j,k,s_v)      += f * (v      - st_arr(i,j,k,s_v));
+                    st_arr(i,j,k,s_w)      += f * (w      - st_arr(i,j,k,s_w));
+                    st_arr(i,j,k,s_p)      += f * (pc     - st_arr(i,j,k,s_p));
+                    st_arr(i,j,k,s_eta)    += f * (e      - st_arr(i,j,k,s_eta));
+                    st_arr(i,j,k,s_uu)     += f * (u * u  - st_arr(i,j,k,s_uu));
+                    st_arr(i,j,k,s_vv)     += f * (v * v  - st_arr(i,j,k,s_vv));
+                    st_arr(i,j,k,s_ww)     += f * (w * w  - st_arr(i,j,k,s_ww));
+                    st_arr(i,j,k,s_uv)     += f * (u * v  - st_arr(i,j,k,s_uv));
+                    st_arr(i,j,k,s_uw)     += f * (u * w  - st_arr(i,j,k,s_uw));
+                    st_arr(i,j,k,s_vw)     += f * (v * w  - st_arr(i,j,k,s_vw));
+                    st_arr(i,j,k,s_pp)     += f * (pc * pc - st_arr(i,j,k,s_pp));
+                    st_arr(i,j,k,s_etaeta) += f * (e * e  - st_arr(i,j,k,s_etaeta));
+                }
+            });
+        }
+    }
+}
+
+//
+// Fill the statistics mf on the grids of level lev > 0 from those of level lev-1, piecewise
+// constant, for level data that didn't exist before. The averages of the products are copied
+// like the means, so that a new fine region carries on with the fluctuations of the coarse
+// level and all levels keep sharing stats_time.
+//
+void incflo::FillStatisticsFromCoarse(int lev, MultiFab& mf) const
+{
+    BL_PROFILE("incflo::FillStatisticsFromCoarse()");
+
+    AMREX_ASSERT(lev > 0 && stats[lev-1]);
+
+    const int nstats = NumStatistics();
+    const IntVect rr = refRatio(lev-1);
+
+    MultiFab crse(amrex::coarsen(mf.boxArray(), rr), mf.DistributionMap(), nstats, 0);
+    crse.setVal(0.);
+    crse.ParallelCopy(*stats[lev-1], 0, 0, nstats, 0, 0, geom[lev-1].periodicity());
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for(MFIter mfi(mf, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+
+        const auto& crse_arr = crse.array(mfi);
+        const auto& fine_arr = mf.array(mfi);
+
+        AMREX_HOST_DEVICE_FOR_4D(bx, nstats, i, j, k, n,
+        {
+            const IntVect civ = amrex::coarsen(IntVect(i,j,k), rr);
+            fine_arr(i,j,k,n) = crse_arr(civ[0],civ[1],civ[2],n);
+        });
+    }
+}
+
+//
+// Write the accumulated statistics as a plotfile:
+// means, RMS fluctuations and Reynolds shear stresses
+//
+void incflo::WriteStatisticsPlotFile() const
+{
+	BL_PROFILE("incflo::WriteStatisticsPlotFile()");
+	INCFLO_TIMER("WriteStatisticsPlotFile");
+
+    if(stats_time <= 0.0) return;
+
+	const std::string& plotfilename = amrex::Concatenate(stats_plot_file, nstep);
+
+	amrex::Print() << "  Writing statistics plotfile " << plotfilename
+                   << " (averaged over " << stats_time << ")" << std::endl;
+
+    Vector<std::string> varnames = {"avg_velx", "avg_vely", "avg_velz", "avg_p", "avg_eta",
+                                    "rms_velx", "rms_vely", "rms_velz", "rms_p", "rms_eta",
+                                    "uv", "uw", "vw"};
+    const int ncomp = varnames.size();
+
+    Vector<std::unique_ptr<MultiFab>> mf(finest_level + 1);
+
+	for(int lev = 0; lev <= finest_level; ++lev)
+	{
+	    mf[lev].reset(new MultiFab(grids[lev], dmap[lev], ncomp, 0, MFInfo(), *ebfactory[lev]));
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for(MFIter mfi(*mf[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+
+            const auto& st_arr = stats[lev]->array(mfi);
+            const auto& mf_arr = mf[lev]->array(mfi);
+
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+            {
+                Real u = st_arr(i,j,k,s_u);
+                Real v = st_arr(i,j,k,s_v);
+                Real w = st_arr(i,j,k,s_w);
+                Real pc = st_arr(i,j,k,s_p);
+                Real e = st_arr(i,j,k,s_eta);
+
+                mf_arr(i,j,k,0) = u;
+                mf_arr(i,j,k,1) = v;
+                mf_arr(i,j,k,2) = w;
+                mf_arr(i,j,k,3) = pc;
+                mf_arr(i,j,k,4) = e;
+
+                // Guard against tiny negative variances due to round-off
+                mf_arr(i,j,k,5) = sqrt(amrex::max(st_arr(i,j,k,s_uu) - u * u, 0.0));
+                mf_arr(i,j,k,6) = sqrt(amrex::max(st_arr(i,j,k,s_vv) - v * v, 0.0));
+                mf_arr(i,j,k,7) = sqrt(amrex::max(st_arr(i,j,k,s_ww) - w * w, 0.0));
+                mf_arr(i,j,k,8) = sqrt(amrex::max(st_arr(i,j,k,s_pp) - pc * pc, 0.0));
+                mf_arr(i,j,k,9) = sqrt(amrex::max(st_arr(i,j,k,s_etaeta) - e * e, 0.0));
+
+                mf_arr(i,j,k,10) = st_arr(i,j,k,s_uv) - u * v;
+                mf_arr(i,j,k,11) = st_arr(i,j,k,s_uw) - u * w;
+                mf_arr(i,j,k,12) = st_arr(i,j,k,s_vw) - v * w;
+            });
+        }
+
+        // Zero out all the values in covered cells
+        EB_set_covered(*mf[lev], 0.0);
+    }
+
+    Vector<int> istep(finest_level + 1, 1);
+
+    amrex::WriteMultiLevelPlotfile(plotfilename, finest_level + 1, GetVecOfConstPtrs(mf),
+                                   varnames, Geom(), cur_time, istep, refRatio());
+
+	WriteJobInfo(plotfilename);
+}
@@ -0,0 +1,89 @@
+#include <AMReX_ParmParse.H>
+
+#include <UnitChecks.H>
+
+#include <algorithm>
+#include <cmath>
+
+UnitChecks::UnitChecks(incflo& _solver)
+    : solver(_solver)
+{
+    readParameters();
+
+    checks = {
+        {"bc_lists",      [this]() { checkBCLists(); }},
+        {"covered_grids", [this]() { checkCoveredGrids(); }},
+        {"eb_cache",      [this]() { checkEBCache(); }},
+        {"eb_tiles",      [this]() { checkEBTiles(); }},
+        {"forces",        [this]() { checkForces(); }},
+        {"restart",       [this]() { checkRestart(); }},
+        {"sampling",      [this]() { checkSampling(); }},
+        {"scratch_pool",  [this]() { checkScratchPool(); }},
+        {"statistics",    [this]() { checkStatistics(); }}
+    };
+
+    Vector<Check> selected;
+    for(const std::string& name : check_names)
+    {
+        bool found = false;
+        for(const Check& c : checks)
+        {
+            if(c.name == name)
+            {
+                selected.push_back(c);
+                found = true;
+            }
+        }
+        if(!found) amrex::Abort("Unknown check in checks.names: " + name);
+    }
+    checks = selected;
+}
+
+void UnitChecks::readParameters()
+{
+    ParmParse pp("checks");
+
+    pp.getarr("names", check_names);
+    pp.query("tol", tol);
+
+    AMREX_ALWAYS_ASSERT(tol > 0.0);
+}
+
+void UnitChecks::run()
+{
+    for(const Check& c : checks)
+    {
+        amrex::Print() << "\nCheck " << c.name << std::endl;
+
+        const int nfailed_before = nfailed;
+        c.f();
+
+        amrex::Print() << "Check " << c.name << ": "
+                       << (nfailed == nfailed_before ? "passed" : "FAILED") << std::endl;
+    }
+
+    if(nfailed > 0)
+    {
+        amrex::Abort(std::to_string(nfailed) + " of " + std::to_string(nchecked) +
+                     " unit check comparisons failed");
+    }
+
+    amrex::Print() << "\nAll unit checks passed (" << nchecked << " comparisons)" << std::endl;
+}
+
+void UnitChecks::check(bool cond, const std::string& what)
+{
+    ParallelDescriptor::ReduceBoolAnd(cond);
+
+    nchecked++;
+    if(!cond)
+    {
+        nfailed++;
+        amrex::Print() << "  FAILED: " << what << std::endl;
+    }
+}
+
+bool UnitChecks::close(Real a, Real b) const
+{
+    return std::abs(a - b) <= tol * std::max(Real(1.0), std::max(std::abs(a), std::abs(b)));
+}
@@ -0,0 +1,141 @@
+#include <UnitChecks.H>
+
+#include <boundary_conditions_F.H>
+
+//
+// Boundary ghost-cell lists
+//
+// The inputs should give every kind of BC: mass inflow, pressure outflow and moving walls.
+// On every level, two copies of the velocity with distinct values in all cells, ghost cells
+// included, get the BCs from the lists of the level (BCList::applyVelocity) and from
+// set_velocity_bcs on every box, which filled the BCs before the lists: all cells must then be
+// the same, with the prescribed values on the faces and in the ghost cells.
+//
+// The scalar BCs (BCList::applyScalar) must copy the cell next to the boundary into the ghost
+// cells outside a single domain face.
+//
+void UnitChecks::checkBCLists()
+{
+    const int nghost = solver.nghost;
+
+    // Distinct values everywhere
+    auto set_values = [](MultiFab& mf)
+    {
+        for(MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            const auto& arr = mf.array(mfi);
+
+            AMREX_HOST_DEVICE_FOR_4D(bx, mf.nComp(), i, j, k, n,
+            {
+                arr(i,j,k,n) = 1.0 + 0.01 * i - 0.02 * j + 0.03 * k + 0.5 * n;
+            });
+        }
+    };
+
+    for(int lev = 0; lev <= solver.finest_level; lev++)
+    {
+        const BCList& bc_list = solver.GetBCList(lev);
+        const Box& domain = solver.geom[lev].Domain();
+        const BoxArray& ba = solver.grids[lev];
+        const DistributionMapping& dm = solver.dmap[lev];
+
+        if(lev == 0)
+        {
+            int nboundary = 0;
+            for(MFIter mfi(*solver.vel[lev]); mfi.isValid(); ++mfi)
+            {
+                if(bc_list.onBoundary(mfi)) nboundary++;
+            }
+            ParallelDescriptor::ReduceIntSum(nboundary);
+            check(nboundary > 0, "bc_lists: no box of level 0 on a physical boundary");
+        }
+
+        for(int extrap_dir_bcs = 0; extrap_dir_bcs < 2; extrap_dir_bcs++)
+        {
+            MultiFab vel_list(ba, dm, 3, nghost);
+            MultiFab vel_fort(ba, dm, 3, nghost);
+            set_values(vel_list);
+            set_values(vel_fort);
+
+            bc_list.applyVelocity(vel_list, extrap_dir_bcs);
+
+            Real time = solver.cur_time;
+            int ng = nghost;
+            int probtype = solver.probtype;
+            for(MFIter mfi(vel_fort); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.fabbox();
+                set_velocity_bcs(&time, bx.loVect(), bx.hiVect(),
+                                 BL_TO_FORTRAN_ANYD(vel_fort[mfi]),
+                                 solver.bc_ilo[lev]->dataPtr(), solver.bc_ihi[lev]->dataPtr(),
+                                 solver.bc_jlo[lev]->dataPtr(), solver.bc_jhi[lev]->dataPtr(),
+                                 solver.bc_klo[lev]->dataPtr(), solver.bc_khi[lev]->dataPtr(),
+                                 domain.loVect(), domain.hiVect(),
+                                 &ng, &extrap_dir_bcs, &probtype);
+            }
+
+            int nwrong = 0;
+            for(MFIter mfi(vel_list); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.fabbox();
+                const auto& l_arr = vel_list.array(mfi);
+                const auto& f_arr = vel_fort.array(mfi);
+
+                for(int n = 0; n < 3; n++)
+                for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+                for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+                for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+                {
+                    if(!close(l_arr(i,j,k,n), f_arr(i,j,k,n))) nwrong++;
+                }
+            }
+
+            check(nwrong == 0, "bc_lists: " + std::to_string(nwrong) + " velocities on level " +
+                  std::to_string(lev) + " differ from set_velocity_bcs with extrap_dir_bcs = " +
+                  std::to_string(extrap_dir_bcs));
+        }
+
+        // Scalars
+        MultiFab s(ba, dm, 2, nghost);
+        MultiFab s0(ba, dm, 2, nghost);
+        set_values(s);
+        set_values(s0);
+        bc_list.applyScalar(s);
+
+        int nwrong = 0;
+        for(MFIter mfi(s); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            const auto& s_arr = s.array(mfi);
+            const auto& s0_arr = s0.array(mfi);
+
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                // Cells outside exactly one non-periodic domain face, and the cell next to it
+                IntVect iv(i,j,k);
+                IntVect inside(iv);
+                int nout = 0;
+                for(int d = 0; d < 3; d++)
+                {
+                    if(iv[d] < domain.smallEnd(d) || iv[d] > domain.bigEnd(d))
+                    {
+                        nout += solver.geom[lev].isPeriodic(d) ? 2 : 1;
+                        inside[d] = amrex::max(domain.smallEnd(d), amrex::min(domain.bigEnd(d), iv[d]));
+                    }
+                }
+                if(nout != 1) continue;
+
+                for(int n = 0; n < 2; n++)
+                {
+                    if(!close(s_arr(i,j,k,n), s0_arr(inside[0],inside[1],inside[2],n))) nwrong++;
+                }
+            }
+        }
+
+        check(nwrong == 0, "bc_lists: " + std::to_string(nwrong) + " scalar ghost cells on level " +
+              std::to_string(lev) + " are not the cell next to the boundary");
+    }
+}
@@ -0,0 +1,73 @@
+#include <UnitChecks.H>
+
+#include <cmath>
+
+//
+// Level 0 grids without the boxes covered by the EB (amr.remove_covered_grids)
+//
+// The inputs must remove some boxes, so that level 0 has holes. The velocity w = sin(2 pi z / Lz)
+// is then projected, as in the initial projection: the Poisson solve must converge with the
+// holes (MLMG aborts if it doesn't), and the divergence must have gone down to the level of
+// the solver tolerance.
+//
+void UnitChecks::checkCoveredGrids()
+{
+    const Geometry& geom0 = solver.geom[0];
+
+    BoxArray full(geom0.Domain());
+    full.maxSize(solver.maxGridSize(0));
+
+    check(solver.remove_covered_grids, "covered_grids: the inputs must set amr.remove_covered_grids");
+    check(solver.grids[0].numPts() < geom0.Domain().numPts(),
+          "covered_grids: no boxes removed, " + std::to_string(solver.grids[0].size()) +
+          " grids of " + std::to_string(full.size()));
+    if(!solver.remove_covered_grids || solver.grids[0].numPts() == geom0.Domain().numPts()) return;
+
+    const Real* plo = geom0.ProbLo();
+    const Real* dx = geom0.CellSize();
+    const Real lz = geom0.ProbLength(2);
+    const Real pi = 4.0 * std::atan(1.0);
+
+    for(int lev = 0; lev <= solver.finest_level; lev++)
+    {
+        for(MFIter mfi(*solver.vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& vel_arr = solver.vel[lev]->array(mfi);
+
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+            {
+                const Real z = plo[2] + (k + 0.5) * dx[2];
+                vel_arr(i,j,k,0) = 0.0;
+                vel_arr(i,j,k,1) = 0.0;
+                vel_arr(i,j,k,2) = std::sin(2.0 * pi * z / lz);
+            });
+        }
+
+        solver.p[lev]->setVal(0.0);
+        solver.gp[lev]->setVal(0.0);
+    }
+
+    Real divu_before = 0.0;
+    {
+        Vector<std::unique_ptr<MultiFab>> divu = solver.ComputeDivU(solver.cur_time);
+        divu_before = divu[0]->norm0();
+        solver.scratch.release(divu);
+    }
+
+    // Initial projection: p = p + phi
+    solver.nstep = -1;
+    solver.ApplyProjection(solver.cur_time, 1.0);
+
+    Real divu_after = 0.0;
+    {
+        Vector<std::unique_ptr<MultiFab>> divu = solver.ComputeDivU(solver.cur_time);
+        divu_after = divu[0]->norm0();
+        solver.scratch.release(divu);
+    }
+
+    check(divu_before > 0.0, "covered_grids: the velocity has no divergence to remove");
+    check(divu_after <= 1.e-6 * divu_before,
+          "covered_grids: max |div u| " + std::to_string(divu_after) + " after the projection, "
+          + std::to_string(divu_before) + " before");
+}
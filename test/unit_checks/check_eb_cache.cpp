@@ -0,0 +1,103 @@
+#include <AMReX_ParmParse.H>
+
+#include <UnitChecks.H>
+
+//
+// EB geometry cache
+//
+// The index space built by EB2::Build when the problem was set up is written to the cache and
+// read back, and new factories are made from the cached index space. On every level, the cell
+// flags, volume fractions and, in the cut cells, the centroids, boundary data, area fractions
+// and face centroids must then be those of the built index space. The cache must not be found
+// for another key.
+//
+// The inputs must not set incflo.eb_cache_dir, so that the setup builds the index space.
+//
+void UnitChecks::checkEBCache()
+{
+    check(solver.eb_cache_dir.empty(), "eb_cache: the inputs must not set incflo.eb_cache_dir");
+    if(!solver.eb_cache_dir.empty()) return;
+
+    solver.eb_cache_dir = "unit_checks_eb_cache";
+
+    std::string geom_type;
+    ParmParse("incflo").query("geometry", geom_type);
+    const std::string key = solver.EBCacheKey(geom_type);
+
+    solver.WriteEBCache(key);
+
+    // The built index space stays below the cached one, and so do the factories made from it
+    Vector<std::unique_ptr<EBFArrayBoxFactory>> built(solver.max_level + 1);
+    for(int lev = 0; lev <= solver.max_level; lev++) built[lev] = std::move(solver.ebfactory[lev]);
+
+    check(!solver.ReadEBCache(key + "other"), "eb_cache: found a cache for another key");
+    check(solver.ReadEBCache(key), "eb_cache: no cache found after writing it");
+    solver.MakeEBFactories();
+
+    for(int lev = 0; lev <= solver.finest_level; lev++)
+    {
+        const EBFArrayBoxFactory& fb = *built[lev];
+        const EBFArrayBoxFactory& fc = *solver.ebfactory[lev];
+
+        const auto& flags_b = fb.getMultiEBCellFlagFab();
+        const auto& flags_c = fc.getMultiEBCellFlagFab();
+
+        // Cut-cell data, one of the factory accessors per entry
+        Vector<std::pair<const MultiCutFab*, const MultiCutFab*>> cut_data = {
+            {&fb.getCentroid(),     &fc.getCentroid()},
+            {&fb.getBndryArea(),    &fc.getBndryArea()},
+            {&fb.getBndryCent(),    &fc.getBndryCent()},
+            {&fb.getBndryNormal(),  &fc.getBndryNormal()}
+        };
+        for(int d = 0; d < AMREX_SPACEDIM; d++)
+        {
+            cut_data.push_back({fb.getAreaFrac()[d], fc.getAreaFrac()[d]});
+            cut_data.push_back({fb.getFaceCent()[d], fc.getFaceCent()[d]});
+        }
+
+        int nwrong = 0;
+        for(MFIter mfi(fb.getVolFrac()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+
+            const FabType type = flags_b[mfi].getType(bx);
+            if(type != flags_c[mfi].getType(bx))
+            {
+                nwrong++;
+                continue;
+            }
+
+            const auto& fl_b = flags_b[mfi].array();
+            const auto& fl_c = flags_c[mfi].array();
+            const auto& vf_b = fb.getVolFrac().array(mfi);
+            const auto& vf_c = fc.getVolFrac().array(mfi);
+
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                if(!(fl_b(i,j,k) == fl_c(i,j,k)) || !close(vf_b(i,j,k), vf_c(i,j,k))) nwrong++;
+            }
+
+            if(type != FabType::singlevalued) continue;
+
+            for(const auto& mfs : cut_data)
+            {
+                const auto& a_b = mfs.first->array(mfi);
+                const auto& a_c = mfs.second->array(mfi);
+                const Box& fbx = (*mfs.first)[mfi].box() & amrex::convert(bx, (*mfs.first)[mfi].box().ixType());
+
+                for(int n = 0; n < mfs.first->nComp(); n++)
+                for(int k = fbx.smallEnd(2); k <= fbx.bigEnd(2); k++)
+                for(int j = fbx.smallEnd(1); j <= fbx.bigEnd(1); j++)
+                for(int i = fbx.smallEnd(0); i <= fbx.bigEnd(0); i++)
+                {
+                    if(!close(a_b(i,j,k,n), a_c(i,j,k,n))) nwrong++;
+                }
+            }
+        }
+
+        check(nwrong == 0, "eb_cache: " + std::to_string(nwrong) + " values on level " +
+              std::to_string(lev) + " differ between the built and the reloaded index space");
+    }
+}
@@ -0,0 +1,94 @@
+#include <UnitChecks.H>
+
+//
+// EB tile cache
+//
+// On every level, the cached EB data of each tile must be what the kernels would find from
+// the cell flags:
+//
+//  - the type of the tile box grown by 0 ... nghost cells is that given by the flags;
+//  - the cut cells are exactly the single-valued cells of the tile box;
+//  - the regular and EB parts don't overlap and make up the tile box (nothing if it is
+//    covered), and the cells of the regular parts only have regular neighbours.
+//
+// This is done for the default tile size and again for a smaller one, for which the cache
+// must be rebuilt.
+//
+void UnitChecks::checkEBTiles()
+{
+    const IntVect default_tile_size = FabArrayBase::mfiter_tile_size;
+
+    for(const IntVect& tile_size : {default_tile_size, IntVect(8, 4, 4)})
+    {
+        FabArrayBase::mfiter_tile_size = tile_size;
+
+        for(int lev = 0; lev <= solver.finest_level; lev++)
+        {
+            const EBTiles& tiles = solver.GetEBTiles(lev);
+            const auto& flags = solver.ebfactory[lev]->getMultiEBCellFlagFab();
+
+            int ntype = 0, ncut = 0, nparts = 0;
+            for(MFIter mfi(*solver.vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const EBCellFlagFab& flag = flags[mfi];
+                const auto& flag_arr = flag.array();
+
+                for(int n = 0; n <= solver.nghost; n++)
+                {
+                    if(tiles.type(mfi, n) != flag.getType(amrex::grow(bx, n))) ntype++;
+                }
+
+                // Cut cells
+                long nsingle = 0;
+                for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+                for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+                for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+                {
+                    if(flag_arr(i,j,k).isSingleValued()) nsingle++;
+                }
+
+                const Vector<IntVect>& cut = tiles.cutCells(mfi);
+                if(static_cast<long>(cut.size()) != nsingle) ncut++;
+                for(const IntVect& iv : cut)
+                {
+                    if(!bx.contains(iv) || !flag_arr(iv[0],iv[1],iv[2]).isSingleValued()) ncut++;
+                }
+
+                // Regular and EB parts
+                Vector<Box> parts;
+                long npts = 0;
+                for(const Box& part : tiles.regularParts(mfi))
+                {
+                    if(flag.getType(amrex::grow(part, 1)) != FabType::regular) nparts++;
+                    parts.push_back(part);
+                }
+                for(const Box& part : tiles.ebParts(mfi)) parts.push_back(part);
+
+                for(int a = 0; a < parts.size(); a++)
+                {
+                    if(!bx.contains(parts[a])) nparts++;
+                    for(int b = a + 1; b < parts.size(); b++)
+                    {
+                        if(parts[a].intersects(parts[b])) nparts++;
+                    }
+                    npts += parts[a].numPts();
+                }
+
+                const long expected = (tiles.type(mfi, 0) == FabType::covered) ? 0 : bx.numPts();
+                if(npts != expected) nparts++;
+            }
+
+            const std::string where = " on level " + std::to_string(lev) + " with tile size " +
+                                      std::to_string(tile_size[0]) + " " +
+                                      std::to_string(tile_size[1]) + " " +
+                                      std::to_string(tile_size[2]);
+
+            check(ntype == 0, "eb_tiles: " + std::to_string(ntype) + " wrong tile types" + where);
+            check(ncut == 0, "eb_tiles: " + std::to_string(ncut) + " wrong cut-cell lists" + where);
+            check(nparts == 0, "eb_tiles: " + std::to_string(nparts) + " wrong tile parts" + where);
+        }
+    }
+
+    FabArrayBase::mfiter_tile_size = default_tile_size;
+}
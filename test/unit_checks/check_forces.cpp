@@ -0,0 +1,83 @@
+#include <AMReX_ParmParse.H>
+
+#include <UnitChecks.H>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+//
+// Force monitor restart
+//
+// A first monitor writes records at t = 1, 2 and 3, as a run that went on past its checkpoint
+// at t = 2 would. A second one restarts at t = 2 and writes a record at t = 2.5: the file must
+// then hold the header and the records at t = 1, 2 and 2.5, in that order.
+//
+void UnitChecks::checkForces()
+{
+    const std::string output_dir{"unit_checks_forces"};
+    {
+        ParmParse pp("forces");
+        pp.add("int", 1);
+        pp.add("flush_int", 100);
+        pp.add("output_dir", output_dir);
+    }
+
+    const std::string FileName(output_dir + "/body.dat");
+    if(ParallelDescriptor::IOProcessor()) std::remove(FileName.c_str());
+
+    Vector<Real> values(ForceMonitor::nvalues, 0.0);
+    {
+        ForceMonitor monitor;
+        check(monitor.numBodies() == 1, "forces: a single body without forces.bodies");
+
+        for(Real t : {1.0, 2.0, 3.0})
+        {
+            values[0] = t;
+            monitor.record(t, values);
+        }
+        monitor.flush();
+    }
+    {
+        ForceMonitor monitor;
+        monitor.restart(2.0);
+
+        values[0] = 2.5;
+        monitor.record(2.5, values);
+        monitor.flush();
+    }
+
+    // Times and first values of the records
+    bool ok = true;
+    std::string times;
+    if(ParallelDescriptor::IOProcessor())
+    {
+        const Vector<Real> expected = {1.0, 2.0, 2.5};
+
+        std::ifstream File(FileName.c_str());
+        std::string line;
+        int nheader = 0;
+        Vector<Real> found;
+        while(std::getline(File, line))
+        {
+            if(!line.empty() && line[0] == '#')
+            {
+                nheader++;
+                continue;
+            }
+
+            Real t = 0.0, fpx = 0.0;
+            std::istringstream is(line);
+            is >> t >> fpx;
+            ok = ok && !is.fail() && close(t, fpx);
+            found.push_back(t);
+            times += " " + std::to_string(t);
+        }
+
+        ok = ok && nheader == 1 && found.size() == expected.size();
+        for(int r = 0; ok && r < found.size(); r++) ok = close(found[r], expected[r]);
+    }
+
+    check(ok, "forces: records after restarting at t = 2:" + times + " (expected one header, "
+              "then 1 2 2.5)");
+}
@@ -0,0 +1,161 @@
+#include <UnitChecks.H>
+
+//
+// Restart onto new grids (amr.regrid_on_restart)
+//
+// The velocity, pressure gradient, pressure, density and viscosity are set to linear functions
+// on all levels and written to a checkpoint, which is then read back with half the
+// max_grid_size. The grids must have been made again:
+//
+//  - level 0 covers the domain with more, smaller boxes;
+//  - the finer levels cover the same region as before, in boxes that respect the blocking
+//    factor and the new max_grid_size;
+//
+// and all the fields must have their values at the same places as before.
+//
+namespace
+{
+    // The fields at x: velocity and pressure gradient (component n), pressure, density and
+    // viscosity
+    Real fieldVel(const Real* x, int n) { return 1.0 + n + x[0] + 2.0 * x[1] + 3.0 * x[2]; }
+    Real fieldGp(const Real* x, int n) { return 2.0 - n * x[0] + x[2]; }
+    Real fieldP(const Real* x) { return x[0] - 2.0 * x[1] + 0.5 * x[2]; }
+    Real fieldRo(const Real* x) { return 1.0 + x[0]; }
+    Real fieldEta(const Real* x) { return 0.5 + x[1]; }
+}
+
+void UnitChecks::checkRestart()
+{
+    const int finest_level = solver.finest_level;
+
+    // Cell centre (nodal = 0) or node (nodal = 1) of iv on level lev
+    auto position = [&](int lev, const IntVect& iv, int nodal, Real* x)
+    {
+        for(int d = 0; d < 3; d++)
+        {
+            x[d] = solver.geom[lev].ProbLo(d) + (iv[d] + (nodal ? 0.0 : 0.5)) * solver.geom[lev].CellSize(d);
+        }
+    };
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        for(MFIter mfi(*solver.vel[lev]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            FArrayBox& vel_fab = (*solver.vel[lev])[mfi];
+            FArrayBox& gp_fab = (*solver.gp[lev])[mfi];
+            FArrayBox& ro_fab = (*solver.ro[lev])[mfi];
+            FArrayBox& eta_fab = (*solver.eta[lev])[mfi];
+            for(IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+            {
+                Real x[3];
+                position(lev, iv, 0, x);
+                for(int n = 0; n < 3; n++)
+                {
+                    vel_fab(iv, n) = fieldVel(x, n);
+                    gp_fab(iv, n) = fieldGp(x, n);
+                }
+                ro_fab(iv) = fieldRo(x);
+                eta_fab(iv) = fieldEta(x);
+            }
+        }
+
+        for(MFIter mfi(*solver.p[lev]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            FArrayBox& p_fab = (*solver.p[lev])[mfi];
+            for(IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+            {
+                Real x[3];
+                position(lev, iv, 1, x);
+                p_fab(iv) = fieldP(x);
+            }
+        }
+    }
+
+    Vector<BoxArray> old_grids(finest_level + 1);
+    for(int lev = 0; lev <= finest_level; lev++) old_grids[lev] = solver.grids[lev];
+
+    solver.check_file = "unit_checks_chk";
+    solver.nstep = 7;
+    solver.WriteCheckPointFile();
+
+    const int max_grid_size = solver.maxGridSize(0)[0] / 2;
+    solver.SetMaxGridSize(max_grid_size);
+    solver.regrid_on_restart = 1;
+    solver.restart_file = amrex::Concatenate(solver.check_file, solver.nstep);
+    solver.ReadCheckpointFile();
+
+    check(solver.finest_level == finest_level, "restart: finest_level " +
+          std::to_string(solver.finest_level) + " (expected " + std::to_string(finest_level) + ")");
+    if(solver.finest_level != finest_level) return;
+
+    // Grids
+    const BoxArray& ba0 = solver.grids[0];
+    check(ba0.numPts() == solver.geom[0].Domain().numPts() && ba0.size() > old_grids[0].size(),
+          "restart: level 0 has " + std::to_string(ba0.size()) + " grids covering " +
+          std::to_string(ba0.numPts()) + " cells, before " + std::to_string(old_grids[0].size()));
+
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        const BoxArray& ba = solver.grids[lev];
+        const IntVect& bf = solver.blockingFactor(lev);
+
+        int nwrong = 0;
+        for(int i = 0; i < ba.size(); i++)
+        {
+            if(ba[i].longside() > max_grid_size) nwrong++;
+            if(lev > 0 && !ba[i].coarsenable(bf)) nwrong++;
+        }
+        if(ba.numPts() != old_grids[lev].numPts() || !old_grids[lev].contains(ba) ||
+           !ba.contains(old_grids[lev]))
+        {
+            nwrong++;
+        }
+
+        check(nwrong == 0, "restart: the grids of level " + std::to_string(lev) + " don't cover "
+              "the same cells as before in boxes of at most " + std::to_string(max_grid_size) +
+              " cells that respect the blocking factor");
+    }
+
+    // Fields
+    for(int lev = 0; lev <= finest_level; lev++)
+    {
+        int nwrong = 0;
+        for(MFIter mfi(*solver.vel[lev]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const FArrayBox& vel_fab = (*solver.vel[lev])[mfi];
+            const FArrayBox& gp_fab = (*solver.gp[lev])[mfi];
+            const FArrayBox& ro_fab = (*solver.ro[lev])[mfi];
+            const FArrayBox& eta_fab = (*solver.eta[lev])[mfi];
+            for(IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+            {
+                Real x[3];
+                position(lev, iv, 0, x);
+                for(int n = 0; n < 3; n++)
+                {
+                    if(!close(vel_fab(iv, n), fieldVel(x, n))) nwrong++;
+                    if(!close(gp_fab(iv, n), fieldGp(x, n))) nwrong++;
+                }
+                if(!close(ro_fab(iv), fieldRo(x))) nwrong++;
+                if(!close(eta_fab(iv), fieldEta(x))) nwrong++;
+            }
+        }
+
+        for(MFIter mfi(*solver.p[lev]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const FArrayBox& p_fab = (*solver.p[lev])[mfi];
+            for(IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+            {
+                Real x[3];
+                position(lev, iv, 1, x);
+                if(!close(p_fab(iv), fieldP(x))) nwrong++;
+            }
+        }
+
+        check(nwrong == 0, "restart: " + std::to_string(nwrong) + " values on level " +
+              std::to_string(lev) + " differ from those written to the checkpoint");
+    }
+}
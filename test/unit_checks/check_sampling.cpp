@@ -0,0 +1,196 @@
+#include <AMReX_ParmParse.H>
+
+#include <UnitChecks.H>
+
+#include <cmath>
+#include <fstream>
+
+//
+// Sampler
+//
+// The velocity, pressure and viscosity are set to linear functions of x on all levels, which
+// the trilinear interpolation reproduces exactly wherever the ghost cells are filled
+// consistently, and the vorticity is then constant. The probes are
+//
+//  - points just inside the level 1 grids, whose stencils reach across the coarse-fine
+//    interface: they must give the exact values, which they only do if they are sampled on
+//    level 0 (the coarse-fine ghost cells of the derived fields are not filled);
+//  - the upper corner of the domain, on the outflow face, which belongs to the last cell: its
+//    velocity is that of the last cell centre, as the outflow BC extrapolates it;
+//  - a point outside the domain, which gives zeros.
+//
+// The points next to the interface are kept 3 coarse cells away from the EB sphere and the
+// x faces, where the derived fields are not exact.
+//
+void UnitChecks::checkSampling()
+{
+    check(solver.finest_level >= 1, "sampling: the inputs must give a refined level");
+    if(solver.finest_level < 1) return;
+
+    const Real a[3] = {1.0, -0.5, 0.25};
+    const Real b[3] = {0.5, 2.0, -1.0};
+    const Real b_p = 2.0;
+    const Real vort_exact = std::sqrt(b[1] * b[1] + b[2] * b[2]);
+
+    for(int lev = 0; lev <= solver.finest_level; lev++)
+    {
+        const Real* plo = solver.geom[lev].ProbLo();
+        const Real* dx  = solver.geom[lev].CellSize();
+
+        for(MFIter mfi(*solver.vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& vel_arr = solver.vel[lev]->array(mfi);
+
+            AMREX_HOST_DEVICE_FOR_4D(bx, 3, i, j, k, n,
+            {
+                vel_arr(i,j,k,n) = a[n] + b[n] * (plo[0] + (i + 0.5) * dx[0]);
+            });
+        }
+
+        for(MFIter mfi(*solver.p[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& p_arr = solver.p[lev]->array(mfi);
+
+            AMREX_HOST_DEVICE_FOR_3D(bx, i, j, k,
+            {
+                p_arr(i,j,k) = b_p * (plo[0] + i * dx[0]);
+            });
+        }
+
+        solver.p0[lev]->setVal(0.0);
+        solver.eta[lev]->setVal(solver.mu);
+
+        // FillPatchVel may take the data at the old time
+        MultiFab::Copy(*solver.vel_o[lev], *solver.vel[lev], 0, 0, 3, 0);
+    }
+
+    // Probe locations and the values expected there (velx vely velz p eta vort)
+    Vector<RealArray> points;
+    Vector<Array<Real, 6>> expected;
+    Vector<int> check_vort;
+
+    const Geometry& geom0 = solver.geom[0];
+    const Geometry& geom1 = solver.geom[1];
+    const Real dx0 = geom0.CellSize(0);
+
+    Vector<Real> center(3, 0.0);
+    Real radius = 0.0;
+    ParmParse pps("sphere");
+    pps.getarr("center", center, 0, 3);
+    pps.get("radius", radius);
+
+    // Cells of the level 1 grids next to the coarse-fine interface, with the point a quarter
+    // cell from the face
+    const BoxArray& ba1 = solver.grids[1];
+    for(int ibox = 0; ibox < ba1.size() && points.size() < 16; ibox++)
+    {
+        const Box& bx = ba1[ibox];
+        for(int dir = 0; dir < 3; dir++)
+        for(int side = 0; side < 2; side++)
+        {
+            IntVect iv = bx.smallEnd();
+            for(int d = 0; d < 3; d++)
+            {
+                if(d != dir) iv[d] = (bx.smallEnd(d) + bx.bigEnd(d)) / 2;
+            }
+            iv[dir] = (side == 0) ? bx.smallEnd(dir) : bx.bigEnd(dir);
+
+            const IntVect out = (side == 0 ? -1 : 1) * IntVect::TheDimensionVector(dir);
+            if(ba1.contains(iv + out)) continue;
+
+            RealArray x;
+            Real dist = 0.0;
+            for(int d = 0; d < 3; d++)
+            {
+                x[d] = geom1.ProbLo(d) + (iv[d] + 0.5 + 0.25 * out[d]) * geom1.CellSize(d);
+                dist += (x[d] - center[d]) * (x[d] - center[d]);
+            }
+            if(std::sqrt(dist) < radius + 3.0 * dx0 ||
+               x[0] < geom0.ProbLo(0) + 3.0 * dx0 || x[0] > geom0.ProbHi(0) - 3.0 * dx0)
+            {
+                continue;
+            }
+
+            points.push_back(x);
+            expected.push_back({a[0] + b[0] * x[0], a[1] + b[1] * x[0], a[2] + b[2] * x[0],
+                                b_p * x[0], solver.mu, vort_exact});
+            check_vort.push_back(1);
+        }
+    }
+    check(!points.empty(), "sampling: no level 1 cells away from the EB next to the coarse-fine interface");
+
+    // Upper corner of the domain, on the outflow face
+    {
+        const RealArray x = {geom0.ProbHi(0), geom0.ProbHi(1), geom0.ProbHi(2)};
+        const Real xc = geom0.ProbHi(0) - 0.5 * dx0;
+        points.push_back(x);
+        expected.push_back({a[0] + b[0] * xc, a[1] + b[1] * xc, a[2] + b[2] * xc,
+                            b_p * x[0], solver.mu, 0.0});
+        check_vort.push_back(0);
+    }
+
+    // Outside the domain
+    points.push_back({geom0.ProbHi(0) + 2.0 * dx0, 0.5 * (geom0.ProbLo(1) + geom0.ProbHi(1)),
+                      0.5 * (geom0.ProbLo(2) + geom0.ProbHi(2))});
+    expected.push_back({0.0, 0.0, 0.0, 0.0, 0.0, 0.0});
+    check_vort.push_back(1);
+
+    // One point probe per location, sampling all fields
+    const std::string output_dir{"unit_checks_samples"};
+    Vector<std::string> names;
+    for(int n = 0; n < points.size(); n++)
+    {
+        names.push_back("check" + std::to_string(n));
+
+        ParmParse ppp("sampling." + names[n]);
+        ppp.add("type", std::string("point"));
+        ppp.addarr("location", std::vector<Real>{points[n][0], points[n][1], points[n][2]});
+    }
+    {
+        ParmParse pp("sampling");
+        pp.add("int", 1);
+        pp.add("flush_int", 1);
+        pp.add("output_dir", output_dir);
+        pp.addarr("probes", names);
+        pp.addarr("fields", std::vector<std::string>{"velx", "vely", "velz", "p", "eta", "vort"});
+    }
+
+    solver.sampler.reset(new Sampler(&solver, &solver.ebfactory));
+    solver.SampleFields();
+    solver.sampler->flush();
+
+    // The last record of every probe file: time, then the 6 fields
+    for(int n = 0; n < points.size(); n++)
+    {
+        bool ok = true;
+        std::string values;
+
+        if(ParallelDescriptor::IOProcessor())
+        {
+            Real record[7];
+            std::ifstream File(output_dir + "/" + names[n] + ".bin", std::ifstream::binary);
+            File.seekg(-static_cast<long>(sizeof(record)), std::ifstream::end);
+            File.read(reinterpret_cast<char*>(record), sizeof(record));
+            ok = File.good();
+
+            for(int f = 0; f < 6 && ok; f++)
+            {
+                if(f == 5 && !check_vort[n]) continue;
+                ok = close(record[f + 1], expected[n][f]);
+            }
+
+            for(int f = 0; f < 6; f++)
+            {
+                values += " " + std::to_string(record[f + 1]) + " (" + std::to_string(expected[n][f]) + ")";
+            }
+        }
+
+        check(ok, "sampling: point " + std::to_string(points[n][0]) + " " + std::to_string(points[n][1])
+                  + " " + std::to_string(points[n][2]) + ", sampled (expected):" + values);
+    }
+
+    // Don't leave the probes to a later check
+    solver.sampler.reset(new Sampler(&solver, &solver.ebfactory, false));
+}
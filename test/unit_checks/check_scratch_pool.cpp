@@ -0,0 +1,94 @@
+#include <UnitChecks.H>
+
+//
+// Scratch MultiFab pool
+//
+// On a pool of its own, on the level 0 grids with the EB factory:
+//
+//  - a buffer has the layout and factory asked for;
+//  - a released buffer is handed out again for the same layout, but not while it is in use,
+//    nor for another number of components or another BoxArray;
+//  - releasing the buffers of all levels at once leaves null pointers and makes them all
+//    available again;
+//  - a disabled pool never reuses a buffer.
+//
+// Then a second call of ComputeDivU must take all its buffers from the pool of the solver.
+//
+void UnitChecks::checkScratchPool()
+{
+    const BoxArray& ba = solver.grids[0];
+    const BoxArray nd_ba = amrex::convert(ba, IntVect{1,1,1});
+    const DistributionMapping& dm = solver.dmap[0];
+    const EBFArrayBoxFactory& factory = *solver.ebfactory[0];
+
+    auto counts = [](const ScratchPool& pool)
+    {
+        return std::to_string(pool.numHits()) + " hits and " + std::to_string(pool.numMisses()) + " misses";
+    };
+
+    {
+        ScratchPool pool;
+
+        std::unique_ptr<MultiFab> a = pool.acquire(ba, dm, 3, 1, factory);
+        check(a->boxArray() == ba && a->DistributionMap() == dm && a->nComp() == 3 &&
+              a->nGrow() == 1 && &a->Factory() == &factory,
+              "scratch_pool: buffer without the layout or factory asked for");
+        check(pool.numHits() == 0 && pool.numMisses() == 1 && pool.peakBytes() > 0,
+              "scratch_pool: " + counts(pool) + " after the first request (expected 0 and 1)");
+
+        const MultiFab* a_ptr = a.get();
+        pool.release(std::move(a));
+
+        std::unique_ptr<MultiFab> b = pool.acquire(ba, dm, 3, 1, factory);
+        check(b.get() == a_ptr && pool.numHits() == 1,
+              "scratch_pool: released buffer not handed out again, " + counts(pool));
+
+        std::unique_ptr<MultiFab> c = pool.acquire(ba, dm, 3, 1, factory);
+        std::unique_ptr<MultiFab> d = pool.acquire(ba, dm, 1, 1, factory);
+        std::unique_ptr<MultiFab> e = pool.acquire(nd_ba, dm, 3, 1, factory);
+        check(c.get() != b.get() && pool.numHits() == 1 && pool.numMisses() == 4,
+              "scratch_pool: buffer in use or of another layout handed out, " + counts(pool));
+
+        Vector<std::unique_ptr<MultiFab>> levels(2);
+        levels[0] = std::move(b);
+        levels[1] = std::move(c);
+        pool.release(levels);
+        check(!levels[0] && !levels[1], "scratch_pool: release of all levels left pointers");
+
+        levels[0] = pool.acquire(ba, dm, 3, 1, factory);
+        levels[1] = pool.acquire(ba, dm, 3, 1, factory);
+        check(pool.numHits() == 3 && pool.numMisses() == 4,
+              "scratch_pool: " + counts(pool) + " after releasing two levels (expected 3 and 4)");
+
+        pool.release(levels);
+        pool.release(std::move(d));
+        pool.release(std::move(e));
+        pool.clear();
+    }
+
+    {
+        ScratchPool pool;
+        pool.setEnabled(false);
+
+        for(int n = 0; n < 2; n++) pool.release(pool.acquire(ba, dm, 3, 1, factory));
+        check(pool.numHits() == 0 && pool.numMisses() == 2,
+              "scratch_pool: " + counts(pool) + " with the pool disabled (expected 0 and 2)");
+    }
+
+    // The solver's own pool, in the same call made twice
+    for(int n = 0; n < 2; n++)
+    {
+        const long hits = solver.scratch.numHits();
+        const long misses = solver.scratch.numMisses();
+
+        Vector<std::unique_ptr<MultiFab>> divu = solver.ComputeDivU(solver.cur_time);
+        solver.scratch.release(divu);
+
+        if(n == 1)
+        {
+            check(solver.scratch.numMisses() == misses &&
+                  solver.scratch.numHits() == hits + solver.finest_level + 1,
+                  "scratch_pool: the second ComputeDivU allocated new buffers");
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include <UnitChecks.H>
+
+#include <cmath>
+
+//
+// Running statistics
+//
+// Two samples are taken, with the velocity q(x) = 1 + x and then 2 q(x) in all components and
+// the coarse cell centres used for x on all levels:
+//
+//  - the first one at 0.3 after stats.start_time, with dt = 0.05, which must be weighted by
+//    the 0.3 since averaging started;
+//  - the second one 0.1 later.
+//
+// This gives <u> = 1.25 q and <uu> = 1.75 q^2 (see StatsComp in statistics.cpp for the
+// components) and stats_time = 0.4. Level 1 is then allocated again as a new level would be,
+// and its statistics must be those of the coarse cells they lie in, not zeros.
+//
+void UnitChecks::checkStatistics()
+{
+    check(solver.stats_start_time >= 0.0, "statistics: the inputs must set stats.start_time");
+    check(solver.finest_level >= 1, "statistics: the inputs must give a refined level");
+    if(solver.stats_start_time < 0.0 || solver.finest_level < 1) return;
+
+    const int s_u = 0;
+    const int s_uu = 5;
+
+    const Real* plo = solver.geom[0].ProbLo();
+    const Real dx0 = solver.geom[0].CellSize(0);
+
+    // Fields of one sample (factor 1 or 2), with x taken at the coarse cell centres
+    auto set_fields = [&](Real factor)
+    {
+        for(int lev = 0; lev <= solver.finest_level; lev++)
+        {
+            const int ratio = (lev == 0) ? 1 : solver.refRatio(0)[0];
+
+            for(MFIter mfi(*solver.vel[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const auto& vel_arr = solver.vel[lev]->array(mfi);
+
+                AMREX_HOST_DEVICE_FOR_4D(bx, 3, i, j, k, n,
+                {
+                    const int ic = amrex::coarsen(IntVect(i,j,k), ratio)[0];
+                    vel_arr(i,j,k,n) = factor * (1.0 + plo[0] + (ic + 0.5) * dx0);
+                });
+            }
+
+            solver.p[lev]->setVal(0.0);
+            solver.p0[lev]->setVal(0.0);
+            solver.eta[lev]->setVal(solver.mu);
+        }
+    };
+
+    solver.stats_time = 0.0;
+    solver.stats_last_time = 0.0;
+    for(int lev = 0; lev <= solver.finest_level; lev++) solver.stats[lev]->setVal(0.0);
+
+    set_fields(1.0);
+    solver.dt = 0.05;
+    solver.cur_time = solver.stats_start_time + 0.3;
+    solver.AccumulateStatistics();
+
+    set_fields(2.0);
+    solver.cur_time += 0.1;
+    solver.AccumulateStatistics();
+
+    check(close(solver.stats_time, 0.4), "statistics: averaging time " +
+          std::to_string(solver.stats_time) + " (expected 0.4)");
+
+    // Level 1 as a new level: its statistics come from level 0 only
+    solver.stats[1]->setVal(-1.0);
+    solver.AllocateArrays(1);
+
+    for(int lev = 0; lev <= 1; lev++)
+    {
+        const int ratio = (lev == 0) ? 1 : solver.refRatio(0)[0];
+        const auto& flags = solver.ebfactory[lev]->getMultiEBCellFlagFab();
+
+        int nwrong = 0;
+        for(MFIter mfi(*solver.stats[lev]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto& st_arr = solver.stats[lev]->array(mfi);
+            const auto& flag_arr = flags[mfi].array();
+
+            for(int k = bx.smallEnd(2); k <= bx.bigEnd(2); k++)
+            for(int j = bx.smallEnd(1); j <= bx.bigEnd(1); j++)
+            for(int i = bx.smallEnd(0); i <= bx.bigEnd(0); i++)
+            {
+                if(flag_arr(i,j,k).isCovered()) continue;
+
+                const int ic = amrex::coarsen(IntVect(i,j,k), ratio)[0];
+                const Real q = 1.0 + plo[0] + (ic + 0.5) * dx0;
+                if(!close(st_arr(i,j,k,s_u), 1.25 * q) || !close(st_arr(i,j,k,s_uu), 1.75 * q * q))
+                {
+                    nwrong++;
+                }
+            }
+        }
+
+        check(nwrong == 0, "statistics: " + std::to_string(nwrong) + " cells on level " +
+              std::to_string(lev) + " don't have <u> = 1.25 q and <uu> = 1.75 q^2");
+    }
+}
@@ -0,0 +1,26 @@
+#include <UnitChecks.H>
+
+int main(int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    { /* These braces are necessary to ensure amrex::Finalize() can be called without explicitly
+        deleting all the incflo member MultiFabs */
+
+    BL_PROFILE_VAR("main()", pmain)
+
+    // Issue an error if input file is not given
+    if(argc < 2) amrex::Abort("Input file must be given as command-line argument.");
+
+    // Set up the problem exactly as the solver does, but don't evolve it
+    incflo my_incflo;
+    my_incflo.GetInputBCs();
+    set_ptr_to_incflo(my_incflo);
+    my_incflo.InitData();
+
+    UnitChecks checks(my_incflo);
+    checks.run();
+
+    BL_PROFILE_VAR_STOP(pmain);
+    }
+	amrex::Finalize();
+}